@@ -0,0 +1,84 @@
+#!/bin/bash
+
+########################################
+############# CSCI 2951-O ##############
+########################################
+E_BADARGS=65
+
+if [ $# -gt 1 ]
+then
+	echo "Usage: `basename $0` [<solver>]"
+	echo "Description:"
+	echo -e "\t This script runs the solver (default bin/solution-b) in each of its modes"
+	echo -e "\t on the toy formulas in tests/ and checks the last line of every run."
+	echo -e "\t It exits with 1 if any check fails."
+	exit $E_BADARGS
+fi
+
+solver=${1:-bin/solution-b}
+failures=0
+
+# expect <exit code> <expected text> <solver arguments>: the run must exit with the code and
+# its last line must contain the text
+expect() {
+	code=$1
+	expected=$2
+	shift 2
+	output=$($solver "$@" 2>&1)
+	returnValue="$?"
+	output=$(echo "$output" | tail -1)
+	if [[ "$returnValue" = "$code" && "$output" == *"$expected"* ]]; then
+		echo "ok      $*"
+	else
+		echo "FAILED  $*"
+		echo -e "\t expected: exit $code, $expected"
+		echo -e "\t got:      exit $returnValue, $output"
+		failures=$((failures + 1))
+	fi
+}
+
+# check <expected text> <solver arguments>: a successful run whose last line contains the text
+check() {
+	expect 0 "$@"
+}
+
+# Model enumeration
+check '"Models": 4, "Complete": true' --enumerate tests/toy_enumerate.cnf
+check '"Models": 2, "Complete": true' --enumerate --project 1 tests/toy_enumerate.cnf
+check '"Models": 3, "Complete": false' --enumerate --max-models 3 tests/toy_enumerate.cnf
+check '"Models": 0, "Complete": true' --enumerate tests/toy_enumerate_unsat.cnf
+
+# Backbone
+check '"Backbone": "1 true 3 false", "BackboneSize": 2' --backbone tests/toy_backbone.cnf
+check '"Result": "UNSAT", "Stats"' --backbone tests/toy_infeasible.cnf
+
+# Symmetry breaking must keep the verdict; the generators are the pigeon and hole swaps
+check '"Result": "SAT"' --symmetry 1 tests/toy_symmetry.cnf
+check '"SymmetryGenerators": 4' --symmetry 1 tests/toy_symmetry.cnf
+check '"Result": "UNSAT"' --symmetry 1 tests/toy_symmetry_unsat.cnf
+check '"Result": "UNSAT"' --symmetry 1 --no-amo tests/toy_symmetry_unsat.cnf
+check '"SymmetryGenerators": 3' --symmetry 1 tests/toy_symmetry_unsat.cnf
+
+# Binary CNF must solve like the DIMACS it was converted from, and a corrupt file is an error
+tmpDir=$(mktemp -d)
+check '"Converted"' --convert $tmpDir/solveable.bin tests/toy_solveable.cnf
+check '"Result": "SAT"' $tmpDir/solveable.bin
+check '"Converted"' --convert $tmpDir/infeasible.bin tests/toy_infeasible.cnf
+check '"Result": "UNSAT"' $tmpDir/infeasible.bin
+size=$(stat -c %s $tmpDir/solveable.bin)
+printf '\xff' | dd of=$tmpDir/solveable.bin bs=1 seek=$((size - 1)) conv=notrunc 2>/dev/null
+expect 1 'checksum mismatch' $tmpDir/solveable.bin
+rm -rf $tmpDir
+
+# The second run of a formula is answered from the result cache
+tmpDir=$(mktemp -d)
+check '"CacheHits": 0' --result-cache $tmpDir tests/toy_solveable.cnf
+check '"Result": "SAT"' --result-cache $tmpDir tests/toy_solveable.cnf
+check '"CacheHits": 1' --result-cache $tmpDir tests/toy_solveable.cnf
+check '"CacheHits": 0' --result-cache $tmpDir tests/toy_infeasible.cnf
+check '"Result": "UNSAT"' --result-cache $tmpDir tests/toy_infeasible.cnf
+check '"CacheHits": 1' --result-cache $tmpDir tests/toy_infeasible.cnf
+rm -rf $tmpDir
+
+echo "$failures checks failed"
+[ $failures -eq 0 ]
@@ -0,0 +1,46 @@
+#ifndef BIT_SOLVER_H
+#define BIT_SOLVER_H
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Largest variable index handled by the bit-parallel engine (four 64-bit words)
+const int BIT_SOLVER_MAX_VARS = 256;
+
+// A set of variables as W 64-bit words; variable v is bit v - 1
+template <size_t W> struct alignas(W * sizeof(uint64_t)) Mask {
+    uint64_t w[W];
+};
+
+// How clause status is computed: portable word loops, or SSE4.1 (W = 2) and AVX2 (W = 4)
+// instructions, which are only used when the CPU running the solver has them
+enum class BitKernel { Portable, Vector };
+
+// DPLL over clauses stored as positive/negative variable masks. Clause status, units and pure
+// literals come from word operations over the masks. Meant for formulas with at most
+// BIT_SOLVER_MAX_VARS variables.
+template <size_t W, BitKernel K> class BitSolver {
+  private:
+    struct BitClause {
+        Mask<W> pos, neg;
+    };
+    std::vector<BitClause> clauses;
+    bool hasEmptyClause;
+    Mask<W> model; // True variables of the satisfying assignment
+
+    bool propagate(Mask<W> &trueVars, Mask<W> &falseVars, int &branch);
+    bool search(const Mask<W> &assignedTrue, const Mask<W> &assignedFalse);
+
+  public:
+    explicit BitSolver(const CNFFormula &formula);
+    bool solve();
+    Assignment getAssignment(int numVars) const;
+};
+
+// Solves the formula with the narrowest BitSolver that fits numVars, vectorized if the CPU
+// supports it
+bool solveBitParallel(const CNFFormula &formula, int numVars, Assignment &assignment);
+
+#endif
@@ -10,9 +10,9 @@ class Solver {
     Assignment assignment;
     bool result;
 
-    bool solve(const CNFFormula &formula, Assignment &assignment);
-    bool unitPropagation(CNFFormula &formula, Assignment &assignment);
-    bool pureLiteralElimination(CNFFormula &formula, Assignment &assignment);
+    bool solve(const CNFFormula &formula, const LiteralCounts &counts, Assignment &assignment);
+    bool unitPropagation(CNFFormula &formula, LiteralCounts &counts, Assignment &assignment);
+    bool pureLiteralElimination(CNFFormula &formula, LiteralCounts &counts, Assignment &assignment);
 
     int chooseLiteral(const CNFFormula &formula);
 
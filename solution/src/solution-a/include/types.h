@@ -9,4 +9,11 @@ using Assignment = std::unordered_map<int, bool>;
 using Clause = std::unordered_set<int>;
 using CNFFormula = std::vector<Clause>;
 
+// Occurrences of each literal in a formula, kept in step with it by assignLiteral. Literals
+// whose negation may have run out of occurrences are queued as pure candidates.
+struct LiteralCounts {
+    std::unordered_map<int, int> counts;
+    std::vector<int> pureCandidates;
+};
+
 #endif
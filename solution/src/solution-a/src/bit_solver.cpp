@@ -0,0 +1,277 @@
+#include "bit_solver.h"
+
+#include <bit>
+#include <climits>
+#include <cstdlib>
+
+// The vector kernels are compiled for their instruction set with target attributes, so the
+// rest of the program does not depend on it, and only called after a CPU check
+#if defined(__x86_64__) || defined(__i386__)
+#define BIT_SOLVER_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/*{{{ Mask operations */
+// Returns true if the clause is satisfied under (t, f); otherwise sets free to its unassigned
+// variables. The portable version; the vector ones below compute the same.
+template <size_t W>
+static bool clauseStatus(const Mask<W> &pos, const Mask<W> &neg, const Mask<W> &t,
+                         const Mask<W> &f, Mask<W> &free) {
+    uint64_t sat = 0;
+    for (size_t i = 0; i < W; i++) {
+        sat |= (pos.w[i] & t.w[i]) | (neg.w[i] & f.w[i]);
+    }
+    if (sat != 0) {
+        return true;
+    }
+    for (size_t i = 0; i < W; i++) {
+        free.w[i] = (pos.w[i] | neg.w[i]) & ~(t.w[i] | f.w[i]);
+    }
+    return false;
+}
+
+#ifdef BIT_SOLVER_X86
+__attribute__((target("sse4.1"))) static bool
+clauseStatusSse(const Mask<2> &pos, const Mask<2> &neg, const Mask<2> &t, const Mask<2> &f,
+                Mask<2> &free) {
+    __m128i p = _mm_load_si128(reinterpret_cast<const __m128i *>(pos.w));
+    __m128i n = _mm_load_si128(reinterpret_cast<const __m128i *>(neg.w));
+    __m128i tv = _mm_load_si128(reinterpret_cast<const __m128i *>(t.w));
+    __m128i fv = _mm_load_si128(reinterpret_cast<const __m128i *>(f.w));
+    __m128i sat = _mm_or_si128(_mm_and_si128(p, tv), _mm_and_si128(n, fv));
+    if (!_mm_testz_si128(sat, sat)) {
+        return true;
+    }
+    _mm_store_si128(reinterpret_cast<__m128i *>(free.w),
+                    _mm_andnot_si128(_mm_or_si128(tv, fv), _mm_or_si128(p, n)));
+    return false;
+}
+
+__attribute__((target("avx2"))) static bool
+clauseStatusAvx2(const Mask<4> &pos, const Mask<4> &neg, const Mask<4> &t, const Mask<4> &f,
+                 Mask<4> &free) {
+    __m256i p = _mm256_load_si256(reinterpret_cast<const __m256i *>(pos.w));
+    __m256i n = _mm256_load_si256(reinterpret_cast<const __m256i *>(neg.w));
+    __m256i tv = _mm256_load_si256(reinterpret_cast<const __m256i *>(t.w));
+    __m256i fv = _mm256_load_si256(reinterpret_cast<const __m256i *>(f.w));
+    __m256i sat = _mm256_or_si256(_mm256_and_si256(p, tv), _mm256_and_si256(n, fv));
+    if (!_mm256_testz_si256(sat, sat)) {
+        return true;
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i *>(free.w),
+                       _mm256_andnot_si256(_mm256_or_si256(tv, fv), _mm256_or_si256(p, n)));
+    return false;
+}
+#endif
+
+template <size_t W, BitKernel K>
+static bool status(const Mask<W> &pos, const Mask<W> &neg, const Mask<W> &t, const Mask<W> &f,
+                   Mask<W> &free) {
+#ifdef BIT_SOLVER_X86
+    if constexpr (K == BitKernel::Vector && W == 2) {
+        return clauseStatusSse(pos, neg, t, f, free);
+    } else if constexpr (K == BitKernel::Vector && W == 4) {
+        return clauseStatusAvx2(pos, neg, t, f, free);
+    }
+#endif
+    return clauseStatus(pos, neg, t, f, free);
+}
+
+template <size_t W> static int popcount(const Mask<W> &m) {
+    int count = 0;
+    for (size_t i = 0; i < W; i++) {
+        count += std::popcount(m.w[i]);
+    }
+    return count;
+}
+
+// Variable of the lowest set bit, 0 if the mask is empty
+template <size_t W> static int firstVar(const Mask<W> &m) {
+    for (size_t i = 0; i < W; i++) {
+        if (m.w[i] != 0) {
+            return static_cast<int>(64 * i) + countr_zero(m.w[i]) + 1;
+        }
+    }
+    return 0;
+}
+
+template <size_t W> static bool contains(const Mask<W> &m, int var) {
+    size_t bit = static_cast<size_t>(var - 1);
+    return (m.w[bit / 64] >> (bit % 64)) & 1;
+}
+
+template <size_t W> static void insert(Mask<W> &m, int var) {
+    size_t bit = static_cast<size_t>(var - 1);
+    m.w[bit / 64] |= uint64_t(1) << (bit % 64);
+}
+/*}}}*/
+
+template <size_t W, BitKernel K>
+BitSolver<W, K>::BitSolver(const CNFFormula &formula) : hasEmptyClause(false), model() {
+    for (const Clause &clause : formula) {
+        if (clause.empty()) {
+            hasEmptyClause = true;
+        }
+        BitClause bits = {};
+        bool tautology = false;
+        for (int lit : clause) {
+            insert(lit > 0 ? bits.pos : bits.neg, abs(lit));
+            tautology = tautology || clause.count(-lit) > 0;
+        }
+        if (!tautology) { // Always satisfied, and one free variable would look like a unit
+            clauses.push_back(bits);
+        }
+    }
+}
+
+// Assigns every unit and pure literal under (trueVars, falseVars). Returns false on a conflict.
+// Otherwise branch is set to the first free literal of a shortest unsatisfied clause, or to 0
+// if every clause is satisfied. Always inlined, so that it is compiled for the instruction set
+// of the propagate() that calls it.
+template <size_t W, BitKernel K, typename Clauses>
+__attribute__((always_inline)) static inline bool
+unitPropagate(const Clauses &clauses, Mask<W> &trueVars, Mask<W> &falseVars, int &branch) {
+    while (true) {
+        bool changed = false;
+        int bestSize = INT_MAX;
+        Mask<W> posFree = {}, negFree = {}; // Free variables per polarity in unsatisfied clauses
+        branch = 0;
+
+        for (const auto &clause : clauses) {
+            Mask<W> free;
+            if (status<W, K>(clause.pos, clause.neg, trueVars, falseVars, free)) {
+                continue;
+            }
+            int size = popcount(free);
+            if (size == 0) {
+                return false; // Every literal is false
+            }
+            if (size == 1) {
+                int var = firstVar(free);
+                insert(contains(clause.pos, var) ? trueVars : falseVars, var);
+                changed = true;
+                continue;
+            }
+            for (size_t i = 0; i < W; i++) {
+                posFree.w[i] |= clause.pos.w[i] & free.w[i];
+                negFree.w[i] |= clause.neg.w[i] & free.w[i];
+            }
+            if (size < bestSize) {
+                bestSize = size;
+                int var = firstVar(free);
+                branch = contains(clause.pos, var) ? var : -var;
+            }
+        }
+        if (changed) {
+            continue; // Units may have satisfied or shortened clauses already scanned
+        }
+
+        // A variable free in one polarity only is pure; the counts are exact after a quiet pass
+        bool pure = false;
+        for (size_t i = 0; i < W; i++) {
+            uint64_t onlyPos = posFree.w[i] & ~negFree.w[i];
+            uint64_t onlyNeg = negFree.w[i] & ~posFree.w[i];
+            trueVars.w[i] |= onlyPos;
+            falseVars.w[i] |= onlyNeg;
+            pure = pure || (onlyPos | onlyNeg) != 0;
+        }
+        if (!pure) {
+            return true;
+        }
+    }
+}
+
+template <size_t W, BitKernel K>
+bool BitSolver<W, K>::propagate(Mask<W> &trueVars, Mask<W> &falseVars, int &branch) {
+    return unitPropagate<W, K>(clauses, trueVars, falseVars, branch);
+}
+
+#ifdef BIT_SOLVER_X86
+// Compiled for the vector kernel's instruction set, so the kernel is inlined into the loop
+template <>
+__attribute__((target("sse4.1"))) bool
+BitSolver<2, BitKernel::Vector>::propagate(Mask<2> &trueVars, Mask<2> &falseVars, int &branch) {
+    return unitPropagate<2, BitKernel::Vector>(clauses, trueVars, falseVars, branch);
+}
+
+template <>
+__attribute__((target("avx2"))) bool
+BitSolver<4, BitKernel::Vector>::propagate(Mask<4> &trueVars, Mask<4> &falseVars, int &branch) {
+    return unitPropagate<4, BitKernel::Vector>(clauses, trueVars, falseVars, branch);
+}
+#endif
+
+// Each call works on its own copy of the masks, so nothing is undone on the way back
+template <size_t W, BitKernel K>
+bool BitSolver<W, K>::search(const Mask<W> &assignedTrue, const Mask<W> &assignedFalse) {
+    Mask<W> trueVars = assignedTrue, falseVars = assignedFalse;
+    int branch;
+    if (!propagate(trueVars, falseVars, branch)) {
+        return false;
+    }
+    if (branch == 0) {
+        model = trueVars;
+        return true;
+    }
+
+    for (int lit : {branch, -branch}) {
+        Mask<W> t = trueVars, f = falseVars;
+        insert(lit > 0 ? t : f, abs(lit));
+        if (search(t, f)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <size_t W, BitKernel K> bool BitSolver<W, K>::solve() {
+    if (hasEmptyClause) {
+        return false;
+    }
+    return search(Mask<W>{}, Mask<W>{});
+}
+
+// Variables that are unassigned in the model are set to false
+template <size_t W, BitKernel K> Assignment BitSolver<W, K>::getAssignment(int numVars) const {
+    Assignment assignment;
+    for (int var = 1; var <= numVars; var++) {
+        assignment[var] = contains(model, var);
+    }
+    return assignment;
+}
+
+template class BitSolver<1, BitKernel::Portable>;
+template class BitSolver<2, BitKernel::Portable>;
+template class BitSolver<2, BitKernel::Vector>;
+template class BitSolver<4, BitKernel::Portable>;
+template class BitSolver<4, BitKernel::Vector>;
+
+template <size_t W, BitKernel K>
+static bool solveWith(const CNFFormula &formula, int numVars, Assignment &assignment) {
+    BitSolver<W, K> solver(formula);
+    if (!solver.solve()) {
+        return false;
+    }
+    assignment = solver.getAssignment(numVars);
+    return true;
+}
+
+bool solveBitParallel(const CNFFormula &formula, int numVars, Assignment &assignment) {
+    bool sse = false, avx2 = false;
+#ifdef BIT_SOLVER_X86
+    __builtin_cpu_init();
+    sse = __builtin_cpu_supports("sse4.1");
+    avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (numVars <= 64) {
+        return solveWith<1, BitKernel::Portable>(formula, numVars, assignment);
+    }
+    if (numVars <= 128) {
+        return sse ? solveWith<2, BitKernel::Vector>(formula, numVars, assignment)
+                   : solveWith<2, BitKernel::Portable>(formula, numVars, assignment);
+    }
+    return avx2 ? solveWith<4, BitKernel::Vector>(formula, numVars, assignment)
+                : solveWith<4, BitKernel::Portable>(formula, numVars, assignment);
+}
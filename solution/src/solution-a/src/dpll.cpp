@@ -1,4 +1,5 @@
 #include "dpll.h"
+#include "bit_solver.h"
 #include "sat_instance.h"
 #include "types.h"
 #include <algorithm>
@@ -16,29 +17,75 @@ bool Solver::getResult() { return this->result; }
 void Solver::solver() {
     // Convert instance to CNFFormula
     CNFFormula formula = this->instance->getFormula();
-    this->result = this->solve(formula, this->assignment);
+
+    // Small formulas fit in a few machine words per clause
+    int maxVar = 0;
+    for (const Clause &clause : formula) {
+        for (int lit : clause) {
+            maxVar = max(maxVar, abs(lit));
+        }
+    }
+    if (maxVar <= BIT_SOLVER_MAX_VARS) {
+        this->result = solveBitParallel(formula, maxVar, this->assignment);
+        return;
+    }
+
+    // Count literals once; assignLiteral keeps the counts up to date from here on
+    LiteralCounts counts;
+    for (const Clause &clause : formula) {
+        for (int lit : clause) {
+            counts.counts[lit]++;
+        }
+    }
+    for (const auto &[lit, count] : counts.counts) {
+        counts.pureCandidates.push_back(lit);
+    }
+    this->result = this->solve(formula, counts, this->assignment);
 }
 
-void assignLiteral(int literal, bool value, Assignment &cur_assignment, CNFFormula &formula) {
+// Drops one occurrence of lit; once none are left, its negation may be pure
+static void removeOccurrence(int lit, LiteralCounts &counts) {
+    auto it = counts.counts.find(lit);
+    if (--it->second == 0) {
+        counts.counts.erase(it);
+        counts.pureCandidates.push_back(-lit);
+    }
+}
+
+void assignLiteral(int literal, bool value, Assignment &cur_assignment, CNFFormula &formula,
+                   LiteralCounts &counts) {
     cur_assignment[abs(literal)] = literal > 0 ? value : !value;
     int now_true = value ? literal : -literal;
 
     formula.erase(remove_if(formula.begin(), formula.end(),
-                            [now_true](const Clause &c) { return c.count(now_true) > 0; }),
+                            [now_true, &counts](const Clause &c) {
+                                if (c.count(now_true) == 0) {
+                                    return false;
+                                }
+                                for (int lit : c) {
+                                    removeOccurrence(lit, counts);
+                                }
+                                return true;
+                            }),
                   formula.end());
     for (Clause &clause : formula) {
-        clause.erase(-now_true);
+        if (clause.erase(-now_true) > 0) {
+            removeOccurrence(-now_true, counts);
+        }
     }
 }
 
-bool Solver::solve(const CNFFormula &formula, Assignment &cur_assignment) {
+bool Solver::solve(const CNFFormula &formula, const LiteralCounts &counts,
+                   Assignment &cur_assignment) {
     CNFFormula reducedFormula = formula;
+    LiteralCounts reducedCounts = counts;
 
     bool updated = true;
     while (updated) {
         updated = false;
-        updated = updated || this->unitPropagation(reducedFormula, cur_assignment);
-        updated = updated || this->pureLiteralElimination(reducedFormula, cur_assignment);
+        updated = updated || this->unitPropagation(reducedFormula, reducedCounts, cur_assignment);
+        updated = updated ||
+                  this->pureLiteralElimination(reducedFormula, reducedCounts, cur_assignment);
     }
 
     // If formula is empty, it's satisfiable
@@ -58,21 +105,23 @@ bool Solver::solve(const CNFFormula &formula, Assignment &cur_assignment) {
 
     Assignment assignment_t = cur_assignment;
     CNFFormula formula_t = reducedFormula;
-    assignLiteral(literal, true, assignment_t, formula_t);
+    LiteralCounts counts_t = reducedCounts;
+    assignLiteral(literal, true, assignment_t, formula_t, counts_t);
 
     // Recur with updated formula
-    if (solve(formula_t, assignment_t))
+    if (solve(formula_t, counts_t, assignment_t))
         return true;
 
     // Restore assignment before trying the other branch
     Assignment assignment_f = cur_assignment;
     CNFFormula formula_f = reducedFormula;
-    assignLiteral(literal, false, assignment_f, formula_f);
+    LiteralCounts counts_f = reducedCounts;
+    assignLiteral(literal, false, assignment_f, formula_f, counts_f);
 
-    return solve(formula_f, assignment_f);
+    return solve(formula_f, counts_f, assignment_f);
 }
 
-bool Solver::unitPropagation(CNFFormula &formula, Assignment &assignment) {
+bool Solver::unitPropagation(CNFFormula &formula, LiteralCounts &counts, Assignment &assignment) {
     bool changed = true;
     bool updated = false;
     while (changed) {
@@ -80,7 +129,7 @@ bool Solver::unitPropagation(CNFFormula &formula, Assignment &assignment) {
         for (auto it = formula.begin(); it != formula.end();) {
             if (it->size() == 1) { // Found a unit clause
                 int unit = *it->begin();
-                assignLiteral(unit, true, assignment, formula);
+                assignLiteral(unit, true, assignment, formula, counts);
 
                 changed = true;
                 updated = true;
@@ -94,20 +143,17 @@ bool Solver::unitPropagation(CNFFormula &formula, Assignment &assignment) {
     return updated;
 }
 
-bool Solver::pureLiteralElimination(CNFFormula &formula, Assignment &assignment) {
-    unordered_map<int, int> literalCounts;
+// Only the literals queued by assignLiteral since the last call can have become pure
+bool Solver::pureLiteralElimination(CNFFormula &formula, LiteralCounts &counts,
+                                    Assignment &assignment) {
     bool updated = false;
 
-    for (const Clause &clause : formula) {
-        for (int lit : clause) {
-            literalCounts[lit]++;
-        }
-    }
-
-    for (const auto &[lit, count] : literalCounts) {
-        if (literalCounts.count(-lit) == 0) { // It's a pure literal
+    while (!counts.pureCandidates.empty()) {
+        int lit = counts.pureCandidates.back();
+        counts.pureCandidates.pop_back();
+        if (counts.counts.count(lit) > 0 && counts.counts.count(-lit) == 0) { // It's a pure literal
             updated = true;
-            assignLiteral(lit, true, assignment, formula);
+            assignLiteral(lit, true, assignment, formula, counts);
         }
     }
     return updated;
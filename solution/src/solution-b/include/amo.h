@@ -0,0 +1,14 @@
+#ifndef AMO_H
+#define AMO_H
+
+#include "types.h"
+#include <cstddef>
+#include <vector>
+
+// Finds groups of at least minSize literals of which every pair is forbidden by a binary
+// clause (-a -b), i.e. pairwise at-most-one encodings, greedily as cliques of the graph those
+// clauses form. The binary clauses a group covers are removed from clauses and the groups are
+// returned. Only meant for the problem clauses, before any watchers are set up.
+std::vector<std::vector<int>> extractAtMostOnes(std::vector<Clause> &clauses, size_t minSize);
+
+#endif
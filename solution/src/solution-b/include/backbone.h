@@ -0,0 +1,34 @@
+#ifndef BACKBONE_H
+#define BACKBONE_H
+
+#include "dpll.h"
+#include "types.h"
+#include <vector>
+
+// Literals that hold in every model, found with one incremental solver. The candidates are the
+// literals of a first model. A chunk of candidates is checked at a time by solving under a
+// clause saying one of them is false, guarded by a selector variable: UNSAT confirms the whole
+// chunk, which is then added as units; SAT gives a model that drops every candidate it falsifies.
+// The chunk grows after confirmations and shrinks after models. Every check prefers the opposite
+// phase of each candidate, and the learned clauses are kept throughout.
+class BackboneFinder {
+  private:
+    Solver &solver;
+    int numVars;
+    int nextSelector;
+    size_t chunkSize;
+    Assignment model; // Of the last satisfiable check
+
+    SolveResult check(const std::vector<int> &chunk);
+
+  public:
+    size_t checks; // Solver calls after the first model
+
+    BackboneFinder(Solver &solver, int numVars);
+    // Result of the formula; if SAT, backbone holds the literals found in variable order. Returns
+    // false if the search was cancelled before every candidate was decided, in which case
+    // backbone holds the part confirmed so far.
+    bool run(SolveResult &result, std::vector<int> &backbone);
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef BINARY_CNF_H
+#define BINARY_CNF_H
+
+#include "sat_instance.h"
+#include <cstdint>
+#include <string>
+
+// Binary CNF container, version 1, little-endian:
+//   header       BinaryHeader below
+//   clause sizes numClauses x uint32
+//   literals     numLits literals as zigzag LEB128 varints, clause after clause
+// The checksum is FNV-1a over everything after the header. Flags must be 0: version 1 has no
+// optional sections, and in particular no occurrence index.
+struct BinaryHeader {
+    char magic[4]; // "CNFB"
+    uint32_t version;
+    uint32_t numVars;
+    uint32_t flags;
+    uint64_t numClauses;
+    uint64_t numLits;
+    uint64_t literalBytes; // Size of the varint block
+    uint64_t checksum;
+};
+
+bool isBinaryCNF(const std::string &fileName);
+// Maps the file and decodes it into the clause vector. The solver keeps every clause in its own
+// vector, so this still allocates once per clause; what it saves over DIMACS is the tokenizing
+// and number parsing. Decoding into one flat literal arena would need a different clause store
+// in the solver and is not done. Throws with an "Error: ..." message on a corrupt file.
+SATInstance loadBinaryCNF(const std::string &fileName);
+// Returns the size of the written file in bytes
+uint64_t writeBinaryCNF(const SATInstance &instance, const std::string &fileName);
+
+#endif
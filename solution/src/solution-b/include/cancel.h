@@ -0,0 +1,25 @@
+#ifndef CANCEL_H
+#define CANCEL_H
+
+#include "timer.h"
+#include <csignal>
+
+// Cooperative cancellation of the search loops. A run is cancelled once stop() is called, which
+// is safe from a signal handler, or once the time limit measured on the given timer has passed.
+// The stop flag is process-wide; the time limit belongs to the calling thread, so the workers of
+// the server can each run a request under its own deadline.
+class Cancel {
+  public:
+    static void stop();
+    static void setTimeLimit(const Timer &clock, double seconds);
+
+    static bool requested(); // The stop flag only, cheap enough to poll every iteration
+    static bool expired();   // The stop flag or the time limit, reads the clock
+
+  private:
+    static volatile std::sig_atomic_t stopFlag;
+    static thread_local const Timer *clock;
+    static thread_local double timeLimit;
+};
+
+#endif
@@ -2,6 +2,8 @@
 #define DIMACS_PARSER_H
 
 #include "sat_instance.h"
+#include <istream>
+SATInstance parseCNF(std::istream &input);
 SATInstance parseCNFFile(const std::string& fileName);
 
 #endif
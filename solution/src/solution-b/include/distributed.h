@@ -0,0 +1,115 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include "dpll.h"
+#include "sat_instance.h"
+#include "socket_io.h"
+#include "stats.h"
+#include "timer.h"
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Settings of the coordinator and its workers; the solver options are the flags of a worker
+struct DistributedOptions {
+    std::string address;     // "host:port" or a Unix socket path, see socket_io.h
+    size_t cubeVars = 3;     // The first cubes fix this many of the most frequent variables
+    double splitAfter = 0.5; // Seconds a cube runs before it is split for an idle worker
+    size_t shareLimit = 8;   // Learned clauses up to this size are shared, 0 for none
+    uint64_t vivifyBudget = 0;
+    int chronoThreshold = -1;
+    size_t memLimit = 0;
+    bool pureLiterals = false;
+    bool detectAmo = true;
+};
+
+// The protocol is line based. The coordinator sends each worker
+//   formula        then the DIMACS formula and "end"
+//   cube <id> <literals> 0
+//   clause <literals> 0    a learned clause of another worker
+//   stop <id>      give up the cube so it can be split
+//   quit
+// and a worker answers a cube with one of
+//   result <id> SAT <model literals> 0
+//   result <id> UNSAT
+//   result <id> UNKNOWN <literal>    stopped; the literal is its first decision, 0 if none
+// and reports its short learned clauses as "learnt <literals> 0" while it works.
+
+// Splits the formula into cubes, conjunctions of literals that together cover every
+// assignment, and hands them to the workers that connect. A worker solves its cube under
+// assumptions and keeps its learned clauses for the next one. Once every cube is refuted the
+// formula is UNSAT; the first model ends the search. When a worker is idle and no cube is left,
+// the cube that has run longest is stopped and split on its worker's first decision into two.
+// The cube of a worker that disconnects goes back to the queue.
+class Coordinator {
+  private:
+    struct Cube {
+        uint64_t id;
+        std::vector<int> literals;
+    };
+    struct Peer {
+        int fd;
+        LineReader reader;
+        std::string outbox; // Not yet written, from the offset sent on
+        size_t sent;
+        bool busy;
+        bool stopping; // Asked to give up its cube
+        Cube cube;
+        Timer clock; // Since the cube was handed out
+
+        explicit Peer(int fd);
+    };
+
+    const SATInstance &instance;
+    DistributedOptions options;
+    std::string formula; // As sent to the workers
+    std::vector<int> frequent; // Variables by decreasing number of occurrences
+    std::deque<Cube> pending;
+    std::vector<std::unique_ptr<Peer>> peers;
+    uint64_t nextId;
+
+    void initialCubes();
+    void split(const Cube &cube, int lit, Stats &stats);
+    void send(Peer &peer, const std::string &message);
+    void flush(Peer &peer);
+    // Handles one line of a worker; true once it has found a model
+    bool handle(Peer &peer, const std::string &line, Assignment &model, Stats &stats);
+    void dispatch();
+    void rebalance();
+
+  public:
+    Coordinator(const SATInstance &instance, const DistributedOptions &options);
+    // Serves workers until the formula is decided, or cancelled with result UNKNOWN. Returns the
+    // exit status.
+    int run(SolveResult &result, Assignment &model, Stats &stats);
+};
+
+// Connects to a coordinator and solves the cubes it sends until told to quit
+class Worker {
+  private:
+    DistributedOptions options;
+    int fd;
+    std::unique_ptr<LineReader> reader;
+    SATInstance instance;
+    Solver solver;
+    int numVars;
+    Timer slice;
+    bool quitting;
+
+    void load();
+    void solveCube(uint64_t id, const std::vector<int> &cube);
+    void share();
+    // Applies what arrived during a slice; true if the cube must be given up
+    bool poll(uint64_t id, int branch);
+
+  public:
+    explicit Worker(const DistributedOptions &options);
+    // Returns the exit status
+    int run();
+};
+
+#endif
@@ -1,27 +1,132 @@
 #ifndef DPLL_H
 #define DPLL_H
 
+#include "amo.h"
+#include "cancel.h"
+#include "occurrences.h"
 #include "sat_instance.h"
+#include "stats.h"
 #include "types.h"
+#include "var_order.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <unistd.h>
 
+// Reason of a decision (or of a variable that is unassigned)
+const size_t NO_REASON = SIZE_MAX;
+// Reason of a literal implied false by an at-most-one constraint, and the conflict of a violated
+// one; see trigger and amoConflict
+const size_t AMO_REASON = SIZE_MAX - 1;
+
 class Solver {
   private:
     SATInstance *instance;
+    Stats stats;
+    std::vector<int> phases; // Preferred polarity per variable (1/-1), empty if none
+    uint64_t vivifyBudget;   // Propagations per vivification pass, 0 to skip it
+    int chronoThreshold;     // Backjumps longer than this go back one level only, -1 to disable
+    size_t memLimit;         // Estimated bytes the search may use, 0 for no limit
+    bool pureLiterals;       // Branch on pure literals first
+    bool detectAmo;          // Replace pairwise at-most-one clauses by native constraints
+
+    // Incremental use: after the first solve() the clause database, learned clauses and
+    // activities are kept, and later calls only backtrack to the root. Assumptions are decided
+    // first, in order, one per decision level.
+    bool initialized;
+    bool ok; // False once the clauses alone are unsatisfiable
+    std::vector<int> assumptions;
+    size_t exportLimit; // Learned clauses up to this size are kept in exported, 0 for none
+    std::vector<std::vector<int>> exported;
+
+    // Assigned literals in assignment order; trailLim[l] is where decision level l + 1 starts.
+    // With chronological backtracking a literal may sit above the start of its own level.
+    std::vector<int> trail;
+    std::vector<size_t> trailLim;
+    std::vector<int> level;     // Decision level of each variable
+    std::vector<size_t> reason; // Clause that implied each variable, NO_REASON for decisions
+    size_t conflictClause;      // Clause found falsified by the last failed propagate()
+    std::vector<bool> seen;     // Scratch for analyze()
+
+    // At-most-one constraints and, per literal (by litIndex), the ones containing it. A literal
+    // implied false by one has reason AMO_REASON and the true literal that forced it as trigger.
+    std::vector<std::vector<int>> amos;
+    std::vector<std::vector<size_t>> amosOf;
+    std::vector<int> trigger;
+    std::vector<int> amoConflict; // The conflict when conflictClause is AMO_REASON
+    std::vector<int> explanation; // Scratch for explain()
+
+    VarOrder order;              // Branching order by activity
+    Occurrences occurrences;     // Literal counts for pure literals, only built if enabled
+    std::vector<int> savedPhase; // Polarity each variable is branched on next (1/-1)
+
+    size_t numLearnts;
+    size_t maxLearnts;
+    size_t clauseBytes; // Estimated footprint of the clauses and their watchers
+    // Learned clauses vivification found implied, detached until reduceDB deletes them
+    std::vector<size_t> implied;
+    uint64_t lastVivify; // Propagations when the last vivification pass ended
 
-    bool dpll();
+    bool init();
+    void growVars(int numVars);
+    SolveResult dpll();
     bool propagate();
-    bool pureLiteralElimination();
+    bool propagateAmo(int p);
+    int pureLiteralElimination();
+    void initOrder(int numVars);
     int chooseLiteral();
 
+    int decisionLevel() const;
+    void newDecisionLevel();
+    void assign(int lit, int lvl, size_t from);
+    void moveWatch(size_t ci, int watchId, size_t k);
+    void backtrack(int target);
+    bool assignUnits();
+
+    void initAmo(int numVars);
+    const std::vector<int> &explain(size_t from, int p);
+    std::vector<int> analyze(int conflictLevel, bool &expanded);
+    bool resolveConflict();
+    size_t addClause(const std::vector<int> &literals, bool learnt, int lbd);
+    size_t learn(const std::vector<int> &literals);
+    void restart();
+    void reduceDB(bool aggressive = false);
+
+    bool attachAtRoot(const std::vector<int> &literals, bool learnt);
+
+    static size_t footprint(const Clause &clause);
+    void countClauseBytes();
+    size_t memoryUsage();
+    bool reclaimMemory();
+
+    std::vector<int> vivifyClause(const std::vector<int> &literals, bool &implied);
+    void vivify(const std::vector<size_t> &candidates, uint64_t budget);
+    void vivifyProblem();
+    void vivifyLearnts();
+
   public:
     Solver();
     void setInstance(SATInstance &instance);
+    void setPhases(const std::vector<int> &phases);
+    void setVivifyBudget(uint64_t budget);
+    void setChronoThreshold(int threshold);
+    void setMemLimit(size_t bytes);
+    void setPureLiterals(bool enabled);
+    void setDetectAmo(bool enabled);
+    void setExportLimit(size_t maxSize);
     Assignment getAssignment();
-    bool solve();
+    Stats &getStats();
+    // Adds a problem clause, also between incremental solves
+    void addInputClause(const std::vector<int> &literals);
+    // Adds a clause implied by the formula, such as one learned by another solver
+    void importLearnt(const std::vector<int> &literals);
+    // UNSAT under assumptions only means the formula has no model that satisfies all of them
+    SolveResult solve(const std::vector<int> &assumptions = {});
+    // Short learned clauses since the last call, for sharing with other solvers
+    std::vector<std::vector<int>> takeExported();
+    // First decision above the assumptions when the last solve stopped, 0 if there was none
+    int branchLiteral() const;
 };
 
 #endif
@@ -0,0 +1,21 @@
+#ifndef ENUMERATE_H
+#define ENUMERATE_H
+
+#include "dpll.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Variables from a list like "1-20,35"
+std::vector<int> parseVarList(const std::string &list);
+
+// All-SAT over a projection in one solver session. After each model a blocking clause over the
+// projected variables rules out that projection, and the solver runs again with its learned
+// clauses and activities. onModel gets each projected model, as literals in projection order,
+// when it is found. Returns true if every model was listed, false if the search stopped at
+// maxModels (0 for no limit) or was cancelled.
+bool enumerateModels(Solver &solver, const std::vector<int> &projection, uint64_t maxModels,
+                     const std::function<void(const std::vector<int> &)> &onModel);
+
+#endif
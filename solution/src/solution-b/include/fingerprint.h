@@ -0,0 +1,21 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 128-bit hash of a clause set that ignores the order of literals within a clause and the order
+// of the clauses: each clause is hashed with its literals sorted, and the clause hashes are added
+// up, which is the same as hashing the sorted list of sorted clauses.
+class Fingerprint {
+  private:
+    uint64_t high, low;
+
+  public:
+    Fingerprint();
+    void add(const std::vector<int> &clause);
+    std::string hex() const; // 32 hex digits
+};
+
+#endif
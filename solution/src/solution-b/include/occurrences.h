@@ -0,0 +1,43 @@
+#ifndef OCCURRENCES_H
+#define OCCURRENCES_H
+
+#include "types.h"
+#include <cstddef>
+#include <vector>
+
+// Occurrence counts of every literal over the problem clauses that are not yet satisfied.
+// Counts change only for the clauses of the literal being assigned or unassigned, so pure
+// literals come out of a stack of candidates instead of a rescan of the formula.
+class Occurrences {
+  private:
+    // Problem clauses flattened: clause c spans lits[clauseStart[c], clauseStart[c + 1])
+    std::vector<int> lits;
+    std::vector<size_t> clauseStart;
+    // Clause indices containing each literal, same layout, indexed by litIndex()
+    std::vector<size_t> occurs;
+    std::vector<size_t> occurStart;
+
+    std::vector<int> numTrue;       // True literals per clause
+    std::vector<int> count;         // Unsatisfied clauses (and AMO constraints) containing each literal
+    std::vector<int> candidates;    // Variables that may have become pure
+
+    static size_t litIndex(int lit);
+
+  public:
+    // Indexes the problem clauses, skipping learned ones, under the current assignment. An
+    // at-most-one constraint stands for the clauses -a | -b over its members, so each member's
+    // negation gets one occurrence that is never retracted: making a member true is never taken
+    // as pure, making it false still can be.
+    void init(const std::vector<Clause> &clauses, const std::vector<std::vector<int>> &amos,
+              int numVars, Assignment &assignment);
+    bool enabled() const;
+    void clear(); // Disables it until the next init
+
+    void onAssign(int lit);
+    void onUnassign(int lit);
+
+    // An unassigned literal whose negation occurs in no unsatisfied clause, or 0 if none
+    int nextPure(Assignment &assignment);
+};
+
+#endif
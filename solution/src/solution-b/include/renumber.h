@@ -0,0 +1,20 @@
+#ifndef RENUMBER_H
+#define RENUMBER_H
+
+#include "sat_instance.h"
+#include "types.h"
+#include <vector>
+
+// Renumbers the variables of an instance in reverse Cuthill-McKee order of the variable
+// interaction graph, so variables sharing clauses get nearby numbers, and sorts the clauses by
+// their lowest variable to match. Models of the renumbered instance map back with restore().
+class Renumbering {
+  private:
+    std::vector<int> toOriginal; // Original number of each new variable
+
+  public:
+    void apply(SATInstance &instance);
+    Assignment restore(const Assignment &assignment) const;
+};
+
+#endif
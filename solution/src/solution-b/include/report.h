@@ -0,0 +1,18 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include "stats.h"
+#include "types.h"
+#include <string>
+
+std::string resultName(SolveResult result);
+
+// The text escaped for use inside a JSON string: quotes, backslashes and control characters
+std::string jsonEscape(const std::string &text);
+
+// The JSON result line (without newline) printed by main and sent back by the server. The model
+// is only included for a SAT result.
+std::string resultJSON(const std::string &instance, double seconds, const std::string &result,
+                       const Assignment &model, const Stats &stats);
+
+#endif
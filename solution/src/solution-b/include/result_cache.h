@@ -0,0 +1,33 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "sat_instance.h"
+#include "types.h"
+#include <cstddef>
+#include <string>
+
+// Verdicts of earlier runs in a directory, one file per formula named by the fingerprint of its
+// clauses, so renamed or reordered copies of a formula hit the same entry. A SAT entry is only
+// used if its model satisfies the formula; an UNSAT entry is trusted on the 128-bit hash and the
+// clause count stored with it. Models in a results log of earlier runs, matched by instance name,
+// are used the same way once they pass the model check.
+class ResultCache {
+  private:
+    std::string directory;
+    std::string resultsLog; // Empty if none
+    std::string entry;      // File of the formula looked up last
+    size_t numClauses;
+
+    static bool satisfies(const SATInstance &instance, const Assignment &model);
+    bool fromLog(const SATInstance &instance, const std::string &name, Assignment &model) const;
+
+  public:
+    ResultCache(const std::string &directory, const std::string &resultsLog);
+    // Call on the formula as parsed, before anything rewrites its clauses
+    bool lookup(const SATInstance &instance, const std::string &name, std::string &result,
+                Assignment &model);
+    // Records the verdict for the formula of the last lookup; UNKNOWN is not stored
+    void store(const std::string &result, const Assignment &model) const;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef SAT_INSTANCE_H
 #define SAT_INSTANCE_H
 
+#include "fingerprint.h"
 #include "types.h"
 #include <iostream>
 #include <queue>
@@ -18,8 +19,9 @@ class SATInstance {
 
     bool isTrue(int lit);
     bool isFalse(int lit);
-    int getNumVars();
-    int getNumClauses();
+    int getNumVars() const;
+    int getNumClauses() const;
+    double averageClauseLength() const;
 
     std::string toString() const;
 
@@ -27,6 +29,7 @@ class SATInstance {
     Assignment assignment;
     std::queue<int> propQueue;
     WatchedLiterals watchers;
+    Fingerprint fingerprint; // Of the clauses as parsed
 
   private:
     int numVars;
@@ -0,0 +1,88 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "dpll.h"
+#include "sat_instance.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Settings of the server; the solver options are the command line flags of a single run
+struct ServerOptions {
+    std::string socketPath;
+    size_t workers = 4;
+    size_t cacheSize = 16;  // Base formulas kept, the least recently used is evicted first
+    double timeLimit = 0.0; // Per request, 0 for none
+    uint64_t vivifyBudget = 0;
+    int chronoThreshold = -1;
+    size_t memLimit = 0;
+    bool pureLiterals = false;
+    bool detectAmo = true;
+};
+
+// Long-running solver service on a Unix domain socket (or TCP, see socket_io.h). A client sends line-based requests:
+//   load <id>    then a DIMACS formula and a line "end": parses it and caches it as base <id>
+//   solve <id>   then extra clauses ("1 -2 0"), assumptions ("a 3 -4 0") and "end": solves the
+//                base incrementally, keeping what its solver learned for later requests
+//   solve        then a DIMACS formula and "end": a one-off solve
+//   drop <id>    evicts base <id>
+// Each request is answered by one line, the JSON result line of main or {"Error": ...}. A
+// connection may send any number of requests; connections are served by a pool of workers.
+class Server {
+  private:
+    // A parsed formula and the solver working on it, used by one request at a time. The extra
+    // clauses of a request are guarded by a fresh selector variable that is assumed for that
+    // request and fixed false afterwards, so all learned clauses stay implied by the base.
+    struct Base {
+        std::mutex lock;
+        SATInstance parsed; // As loaded, to start over once retired clauses pile up
+        SATInstance instance;
+        Solver solver;
+        int numVars; // Variables of the formula; selectors are numbered above
+        int nextSelector;
+        size_t retiredClauses;
+
+        explicit Base(SATInstance formula);
+    };
+
+    ServerOptions options;
+
+    std::list<std::pair<std::string, std::shared_ptr<Base>>> lru; // Most recent first
+    std::unordered_map<std::string, decltype(lru)::iterator> cached;
+    std::mutex cacheLock;
+
+    std::queue<int> pending; // Accepted connections waiting for a worker
+    std::mutex queueLock;
+    std::condition_variable queueReady;
+    bool stopping;
+
+    void configure(Solver &solver) const;
+    std::shared_ptr<Base> lookup(const std::string &id);
+    void store(const std::string &id, std::shared_ptr<Base> base);
+    void reset(Base &base) const;
+
+    std::string load(const std::string &id, const std::vector<std::string> &body);
+    std::string solve(const std::vector<std::string> &body);
+    std::string solveBase(const std::string &id, const std::vector<std::string> &body);
+    std::string drop(const std::string &id);
+    std::string handle(const std::string &command, const std::string &id,
+                       const std::vector<std::string> &body);
+
+    void serve(int client);
+    void work();
+
+  public:
+    explicit Server(const ServerOptions &options);
+    // Serves until SIGINT/SIGTERM; returns the exit status
+    int run();
+};
+
+#endif
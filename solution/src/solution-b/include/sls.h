@@ -0,0 +1,59 @@
+#ifndef SLS_H
+#define SLS_H
+
+#include "sat_instance.h"
+#include "stats.h"
+#include "types.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// ProbSAT stochastic local search over the clauses of a SATInstance.
+// Can either solve on its own or seed the phases of the systematic Solver.
+class LocalSearch {
+  private:
+    int numVars;
+    bool hasEmptyClause;
+
+    // Clauses flattened into one array: clause c spans lits[clauseStart[c], clauseStart[c + 1])
+    std::vector<int> lits;
+    std::vector<size_t> clauseStart;
+    // Clause indices containing each literal, same layout, indexed by litIndex()
+    std::vector<uint32_t> occurs;
+    std::vector<size_t> occurStart;
+
+    std::vector<int> value;        // 1 or -1 for every variable
+    std::vector<int> numTrue;      // Number of true literals per clause
+    std::vector<int> trueVarXor;   // XOR of the true variables; the critical one if numTrue == 1
+    std::vector<int> breakCount;   // Clauses that become unsat if the variable flips
+    std::vector<int> makeCount;    // Unsat clauses that become sat if the variable flips
+    std::vector<uint32_t> unsat;   // Currently unsatisfied clauses
+    std::vector<size_t> unsatPos;  // Position of each clause in unsat
+
+    std::vector<int> bestValue;    // Best assignment seen, once saveBest folds in the trail
+    std::vector<int> sinceBest;    // Variables flipped since the best assignment
+    bool bestStale;                // The best is value with sinceBest undone, not bestValue
+    size_t bestNumUnsat;
+
+    std::vector<double> breakProb; // ProbSAT weight indexed by break count
+    std::vector<double> weights;   // Scratch space for pickVar
+    std::mt19937 rng;
+
+    size_t litIndex(int lit) const;
+    void initAssignment();
+    void addUnsat(uint32_t c);
+    void removeUnsat(uint32_t c);
+    int pickVar(uint32_t c);
+    void flip(int var);
+    void saveBest();
+
+  public:
+    LocalSearch(SATInstance &instance, uint32_t seed = 0);
+    bool run(uint64_t maxFlips, Stats &stats);
+
+    // Best assignment seen so far as 1/-1 per variable (index 0 unused)
+    const std::vector<int> &getPhases() const;
+    Assignment getAssignment() const;
+};
+
+#endif
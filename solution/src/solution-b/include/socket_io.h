@@ -0,0 +1,41 @@
+#ifndef SOCKET_IO_H
+#define SOCKET_IO_H
+
+#include <string>
+
+// Line-based socket helpers shared by the server and the distributed mode. An address is either
+// "host:port" for TCP or a path for a Unix domain socket; anything with a '/' or without a ':'
+// is a path.
+
+bool isUnixAddress(const std::string &address);
+// A listening socket, -1 with errno set on failure. A stale Unix socket file is replaced.
+int listenOn(const std::string &address);
+// A connected socket, -1 with errno set on failure
+int connectTo(const std::string &address);
+// Removes the socket file of a Unix address once its listener is closed
+void removeAddress(const std::string &address);
+
+// Writes all of data, false once the peer is gone
+bool sendAll(int fd, const std::string &data);
+
+// Splits what arrives on a connection into lines, without their line terminators
+class LineReader {
+  private:
+    int fd;
+    std::string buffer;
+    bool closed;
+
+    bool take(std::string &line);
+    bool receive(); // One read; false at end of stream or on an error
+
+  public:
+    explicit LineReader(int fd);
+    // Waits for a line; false at end of stream or once cancellation is requested
+    bool next(std::string &line);
+    // A line if one has already arrived, without waiting
+    bool poll(std::string &line);
+    // The peer closed the connection and every line was taken
+    bool done() const;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Search counters reported in the "Stats" field of the JSON result line.
+struct Stats {
+    uint64_t decisions = 0;
+    uint64_t pureLiterals = 0; // Decisions on pure literals, not counted in decisions
+    uint64_t propagations = 0;
+    uint64_t conflicts = 0;
+    uint64_t restarts = 0;
+    double searchTime = 0.0;
+
+    // Clause learning
+    uint64_t learnedClauses = 0;
+    uint64_t learnedLiterals = 0;
+    uint64_t deletedClauses = 0;
+
+    // Chronological backtracking: how often it replaced a backjump, and how many trail
+    // literals the backjumps would have undone
+    uint64_t chronoBacktracks = 0;
+    uint64_t trailKept = 0;
+
+    // Memory budget: highest estimated footprint and forced learned clause reductions
+    size_t peakMemory = 0;
+    uint64_t memoryReductions = 0;
+
+    // At-most-one constraints found and the binary clauses they replaced
+    uint64_t amoConstraints = 0;
+    uint64_t amoClausesRemoved = 0;
+
+    // Symmetry breaking: automorphism generators found and the lex-leader clauses added for them
+    uint64_t symmetryGenerators = 0;
+    uint64_t symmetryClauses = 0;
+
+    // Result taken from the result cache instead of a search
+    uint64_t cacheHits = 0;
+
+    // Distributed mode: cubes refuted by workers, cubes split for idle workers, and learned
+    // clauses passed on between workers
+    uint64_t cubesSolved = 0;
+    uint64_t cubeSplits = 0;
+    uint64_t sharedClauses = 0;
+
+    // Vivification: clauses shortened, literals removed from them, and learned clauses deleted
+    // as implied. Shortened learned clauses also lower learnedLiterals.
+    uint64_t vivifiedClauses = 0;
+    uint64_t vivifiedLiterals = 0;
+    uint64_t vivifiedDeleted = 0;
+    double avgClauseLength = 0.0;
+
+    // Local search
+    uint64_t flips = 0;
+    double slsTime = 0.0;
+
+    std::string toJSON() const;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "sat_instance.h"
+#include "stats.h"
+#include "timer.h"
+#include "types.h"
+#include <cstdint>
+#include <vector>
+
+// Static symmetry breaking. Builds the colored graph of the instance (a vertex per literal and
+// per clause, literal-clause edges and an edge between each literal and its negation), finds
+// generators of its automorphism group by individualization and partition refinement, and adds
+// lex-leader clauses for every generator over new auxiliary variables.
+class SymmetryBreaker {
+  private:
+    int firstAuxVar; // Auxiliary variables start here, 0 if none were added
+    Timer clock;
+    double timeBudget; // Seconds for generator search
+
+    // The colored graph in CSR form: literal l is vertex litVertex(l), clause c is 2n + c
+    int numVars;
+    std::vector<size_t> adjStart;
+    std::vector<uint32_t> adj;
+    std::vector<uint32_t> initialColors;
+
+    uint32_t litVertex(int lit) const;
+    int vertexLit(uint32_t vertex) const;
+    void buildGraph(const std::vector<Clause> &clauses);
+
+    size_t refine(std::vector<uint32_t> &colors) const;
+    void individualize(std::vector<uint32_t> &colors, uint32_t vertex) const;
+    std::vector<uint32_t> targetCell(const std::vector<uint32_t> &colors) const;
+    bool descend(std::vector<uint32_t> &colors) const;
+    bool isAutomorphism(const std::vector<uint32_t> &perm) const;
+
+    std::vector<std::vector<uint32_t>> findGenerators();
+    void addLexLeader(SATInstance &instance, const std::vector<uint32_t> &perm, int &nextVar,
+                      Stats &stats);
+
+  public:
+    SymmetryBreaker();
+    void apply(SATInstance &instance, double budget, Stats &stats);
+    // Drops the auxiliary variables from a model of the extended instance
+    void strip(Assignment &assignment) const;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Binary event tracing of the search, for offline profiling with trace_reader. It is compiled in
+// with -DSAT_TRACE (make TRACE=1); otherwise TRACE_EVENT expands to nothing and its arguments
+// are not evaluated. When compiled in, events are only kept while a trace file is open.
+//
+// Each thread appends fixed-size records to its own ring buffer, and a background thread
+// drains the buffers to the file. A full buffer drops records rather than stall the search;
+// the number dropped is written as a Dropped record when the trace is closed.
+
+enum class TraceEvent : uint16_t {
+    SolveBegin, // a: assumptions
+    SolveEnd,   // a: SolveResult, 0 SAT, 1 UNSAT, 2 UNKNOWN
+    Decide,     // a: literal
+    Propagate,  // a: literals propagated, b: 1 if it ended in a conflict
+    Conflict,   // a: size of the conflicting clause, b: trail size
+    Learn,      // a: size of the learned clause, b: backjump distance in levels
+    Restart,    // a: restarts so far, b: learned clauses kept
+    Dropped,    // a: records lost to a full buffer of this thread
+};
+
+struct TraceRecord {
+    uint64_t nanos; // Since the trace was opened
+    TraceEvent event;
+    uint16_t thread; // In order of the first record of each thread
+    int32_t level;   // Decision level
+    int32_t a;
+    int32_t b;
+};
+static_assert(sizeof(TraceRecord) == 24);
+
+// The file is this header followed by records, in time order per thread only
+struct TraceHeader {
+    char magic[8]; // "SATTRACE"
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+constexpr char TRACE_MAGIC[8] = {'S', 'A', 'T', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+namespace Trace {
+// Starts writing to path; false if tracing is compiled out or the file cannot be created
+bool open(const std::string &path);
+// Drains every buffer and closes the file; also done at exit
+void close();
+void record(TraceEvent event, int level, int64_t a, int64_t b);
+} // namespace Trace
+
+#ifdef SAT_TRACE
+constexpr bool TRACE_COMPILED = true;
+#define TRACE_EVENT(event, level, a, b)                                                           \
+    Trace::record(TraceEvent::event, level, static_cast<int64_t>(a), static_cast<int64_t>(b))
+#else
+constexpr bool TRACE_COMPILED = false;
+#define TRACE_EVENT(event, level, a, b) ((void)0)
+#endif
+
+#endif
@@ -4,6 +4,7 @@
 #include <optional>
 #include <set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <memory>
 
@@ -12,8 +13,13 @@ struct Clause {
     // Indices (into literals vector) for the two watched literals.
     // For unit clauses only watch1 is valid.
     std::optional<size_t> watch1, watch2;
+    // Learned clauses carry their LBD (number of distinct decision levels when learned)
+    bool learnt;
+    int lbd;
+    bool vivified; // Already probed by vivification
 
-    Clause(const std::vector<int> &lits) : literals(lits) {
+    Clause(std::vector<int> lits, bool learnt = false, int lbd = 0)
+        : literals(std::move(lits)), learnt(learnt), lbd(lbd), vivified(false) {
         if (!literals.empty()) {
             watch1 = 0;
         }
@@ -28,4 +34,7 @@ struct Clause {
 using WatchedLiterals = std::unordered_map<int, std::set<std::pair<size_t, int>>>;
 using Assignment = std::unordered_map<int, int>;
 
+// Outcome of a search; UNKNOWN when it gave up before deciding the formula
+enum class SolveResult { SAT, UNSAT, UNKNOWN };
+
 #endif
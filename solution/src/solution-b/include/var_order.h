@@ -0,0 +1,35 @@
+#ifndef VAR_ORDER_H
+#define VAR_ORDER_H
+
+#include <cstddef>
+#include <vector>
+
+// Binary max-heap of variables ordered by VSIDS activity. Variables involved in conflicts are
+// bumped, and all activities decay geometrically by growing the bump increment instead.
+class VarOrder {
+  public:
+    VarOrder();
+    void init(int numVars);
+    void grow(int numVars); // Makes room for new variables, keeping the current activities
+
+    void setActivity(int var, double value);
+    void bump(int var);
+    void decay();
+
+    void insert(int var);
+    bool contains(int var) const;
+    bool empty() const;
+    int removeMax();
+
+  private:
+    std::vector<double> activity;
+    std::vector<int> heap;
+    std::vector<int> position; // Index of each variable in heap, -1 if absent
+    double increment;
+
+    bool before(int a, int b) const;
+    void up(std::size_t i);
+    void down(std::size_t i);
+};
+
+#endif
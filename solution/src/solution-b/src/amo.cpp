@@ -0,0 +1,80 @@
+#include "amo.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+// Key of the edge between two literals that may not both be true
+static uint64_t edgeKey(int a, int b) {
+    if (a > b) {
+        swap(a, b);
+    }
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+vector<vector<int>> extractAtMostOnes(vector<Clause> &clauses, size_t minSize) {
+    // Clause (a b) forbids -a and -b together
+    unordered_set<uint64_t> edges;
+    unordered_map<int, vector<int>> adjacent;
+    for (const Clause &clause : clauses) {
+        if (clause.literals.size() != 2 || clause.literals[0] == -clause.literals[1]) {
+            continue;
+        }
+        int a = -clause.literals[0], b = -clause.literals[1];
+        if (a != b && edges.insert(edgeKey(a, b)).second) {
+            adjacent[a].push_back(b);
+            adjacent[b].push_back(a);
+        }
+    }
+
+    vector<int> literals;
+    for (const auto &[lit, neighbors] : adjacent) {
+        if (neighbors.size() + 1 >= minSize) {
+            literals.push_back(lit);
+        }
+    }
+    auto byDegree = [&adjacent](int a, int b) {
+        size_t da = adjacent[a].size(), db = adjacent[b].size();
+        return da != db ? da > db : a < b;
+    };
+    sort(literals.begin(), literals.end(), byDegree);
+
+    // Grow a clique from each literal over the edges no earlier group has taken
+    vector<vector<int>> groups;
+    unordered_set<uint64_t> covered;
+    for (int lit : literals) {
+        vector<int> group = {lit};
+        vector<int> candidates = adjacent[lit];
+        sort(candidates.begin(), candidates.end(), byDegree);
+        for (int other : candidates) {
+            bool joins = all_of(group.begin(), group.end(), [&](int member) {
+                uint64_t key = edgeKey(member, other);
+                return edges.count(key) > 0 && covered.count(key) == 0;
+            });
+            if (joins) {
+                group.push_back(other);
+            }
+        }
+        if (group.size() < minSize) {
+            continue;
+        }
+        for (size_t i = 0; i < group.size(); i++) {
+            for (size_t j = i + 1; j < group.size(); j++) {
+                covered.insert(edgeKey(group[i], group[j]));
+            }
+        }
+        groups.push_back(move(group));
+    }
+
+    if (!groups.empty()) {
+        erase_if(clauses, [&covered](const Clause &clause) {
+            return clause.literals.size() == 2 &&
+                   covered.count(edgeKey(-clause.literals[0], -clause.literals[1])) > 0;
+        });
+    }
+    return groups;
+}
@@ -0,0 +1,81 @@
+#include "backbone.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+static const size_t MAX_CHUNK = 1024;
+
+BackboneFinder::BackboneFinder(Solver &solver, int numVars)
+    : solver(solver), numVars(numVars), nextSelector(numVars + 1), chunkSize(1), checks(0) {}
+
+// UNSAT if no model falsifies a literal of the chunk, otherwise SAT with such a model in model.
+// A single literal is a plain assumption.
+SolveResult BackboneFinder::check(const vector<int> &chunk) {
+    checks++;
+    int selector = 0;
+    vector<int> assumptions = {-chunk[0]};
+    if (chunk.size() > 1) {
+        selector = nextSelector++;
+        vector<int> clause = {-selector};
+        for (int lit : chunk) {
+            clause.push_back(-lit);
+        }
+        solver.addInputClause(clause);
+        assumptions = {selector};
+    }
+    SolveResult result = solver.solve(assumptions);
+    if (result == SolveResult::SAT) {
+        model = solver.getAssignment(); // Before a new clause backtracks it away
+    }
+    if (selector != 0) {
+        solver.addInputClause({-selector}); // Retires the clause for later checks
+    }
+    return result;
+}
+
+bool BackboneFinder::run(SolveResult &result, vector<int> &backbone) {
+    backbone.clear();
+    result = solver.solve();
+    if (result != SolveResult::SAT) {
+        return result == SolveResult::UNSAT;
+    }
+
+    vector<int> candidates;
+    model = solver.getAssignment();
+    for (int var = 1; var <= numVars; var++) {
+        if (model[var] != 0) { // An unassigned variable is free in this model
+            candidates.push_back(model[var] == 1 ? var : -var);
+        }
+    }
+
+    bool complete = true;
+    while (!candidates.empty()) {
+        size_t size = min(chunkSize, candidates.size());
+        vector<int> chunk(candidates.end() - static_cast<ptrdiff_t>(size), candidates.end());
+        // Models that falsify many candidates at once rule them all out
+        vector<int> phases(static_cast<size_t>(numVars) + 1, 0);
+        for (int lit : candidates) {
+            phases[static_cast<size_t>(abs(lit))] = lit > 0 ? -1 : 1;
+        }
+        solver.setPhases(phases);
+        SolveResult checked = check(chunk);
+        if (checked == SolveResult::UNSAT) {
+            for (int lit : chunk) {
+                backbone.push_back(lit);
+                solver.addInputClause({lit});
+            }
+            candidates.resize(candidates.size() - size);
+            chunkSize = min(2 * chunkSize, MAX_CHUNK);
+        } else if (checked == SolveResult::SAT) {
+            erase_if(candidates, [&](int lit) { return model[abs(lit)] != (lit > 0 ? 1 : -1); });
+            chunkSize = max<size_t>(chunkSize / 2, 1);
+        } else {
+            complete = false;
+            break;
+        }
+    }
+    sort(backbone.begin(), backbone.end(), [](int a, int b) { return abs(a) < abs(b); });
+    return complete;
+}
@@ -0,0 +1,168 @@
+#include "binary_cnf.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char MAGIC[4] = {'C', 'N', 'F', 'B'};
+static const uint32_t VERSION = 1;
+
+static uint64_t fnv1a(const unsigned char *data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool isBinaryCNF(const string &fileName) {
+    ifstream file(fileName, ios::binary);
+    char magic[4];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(magic)) == 0;
+}
+
+/*{{{ Loading */
+// Read-only mapping of a whole file, unmapped when it goes out of scope
+class MappedFile {
+  private:
+    void *data;
+    size_t length;
+
+  public:
+    explicit MappedFile(const string &fileName) : data(MAP_FAILED), length(0) {
+        int fd = open(fileName.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) < 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            throw runtime_error("Error: cannot open binary CNF file: " + fileName);
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (data == MAP_FAILED) {
+            throw runtime_error("Error: cannot map binary CNF file: " + fileName);
+        }
+        madvise(data, length, MADV_SEQUENTIAL);
+    }
+    ~MappedFile() {
+        if (data != MAP_FAILED) {
+            munmap(data, length);
+        }
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const unsigned char *bytes() const { return static_cast<const unsigned char *>(data); }
+    size_t size() const { return length; }
+};
+
+SATInstance loadBinaryCNF(const string &fileName) {
+    MappedFile file(fileName);
+    BinaryHeader header;
+    if (file.size() < sizeof(header)) {
+        throw invalid_argument("Error: binary CNF file is truncated.");
+    }
+    memcpy(&header, file.bytes(), sizeof(header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.flags != 0) {
+        throw invalid_argument("Error: unsupported binary CNF version or flags.");
+    }
+
+    const unsigned char *payload = file.bytes() + sizeof(header);
+    size_t payloadSize = file.size() - sizeof(header);
+    if (header.numClauses > payloadSize / sizeof(uint32_t) ||
+        header.numClauses * sizeof(uint32_t) + header.literalBytes != payloadSize) {
+        throw invalid_argument("Error: binary CNF sections do not match the file size.");
+    }
+    if (fnv1a(payload, payloadSize) != header.checksum) {
+        throw invalid_argument("Error: binary CNF checksum mismatch.");
+    }
+
+    size_t numClauses = static_cast<size_t>(header.numClauses);
+    SATInstance instance(static_cast<int>(header.numVars), static_cast<int>(numClauses));
+    instance.clauses.reserve(numClauses);
+    uint64_t numLits = 0;
+    const unsigned char *in = payload + numClauses * sizeof(uint32_t);
+    const unsigned char *end = in + header.literalBytes;
+    for (size_t c = 0; c < numClauses; c++) {
+        uint32_t size;
+        memcpy(&size, payload + c * sizeof(uint32_t), sizeof(size));
+        vector<int> literals(size);
+        numLits += size;
+        for (int &lit : literals) {
+            uint64_t zigzag = 0;
+            for (int shift = 0;; shift += 7) {
+                if (in == end || shift > 35) {
+                    throw invalid_argument("Error: binary CNF literal block is corrupt.");
+                }
+                zigzag |= static_cast<uint64_t>(*in & 0x7f) << shift;
+                if ((*in++ & 0x80) == 0) {
+                    break;
+                }
+            }
+            int64_t value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+            lit = static_cast<int>(value);
+        }
+        instance.fingerprint.add(literals);
+        instance.clauses.emplace_back(std::move(literals));
+    }
+    if (in != end || numLits != header.numLits) {
+        throw invalid_argument("Error: binary CNF literal block is longer than its clauses.");
+    }
+    return instance;
+} /*}}}*/
+
+uint64_t writeBinaryCNF(const SATInstance &instance, const string &fileName) {
+    vector<unsigned char> payload(instance.clauses.size() * sizeof(uint32_t));
+    uint64_t numLits = 0;
+    int numVars = instance.getNumVars();
+    for (size_t c = 0; c < instance.clauses.size(); c++) {
+        const vector<int> &literals = instance.clauses[c].literals;
+        uint32_t size = static_cast<uint32_t>(literals.size());
+        memcpy(payload.data() + c * sizeof(uint32_t), &size, sizeof(size));
+        numLits += size;
+    }
+    for (const Clause &clause : instance.clauses) {
+        for (int lit : clause.literals) {
+            numVars = max(numVars, abs(lit));
+            uint64_t zigzag = (static_cast<uint64_t>(static_cast<int64_t>(lit)) << 1) ^
+                              static_cast<uint64_t>(static_cast<int64_t>(lit) >> 63);
+            while (zigzag >= 0x80) {
+                payload.push_back(static_cast<unsigned char>(zigzag | 0x80));
+                zigzag >>= 7;
+            }
+            payload.push_back(static_cast<unsigned char>(zigzag));
+        }
+    }
+
+    BinaryHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.numVars = static_cast<uint32_t>(numVars);
+    header.numClauses = instance.clauses.size();
+    header.numLits = numLits;
+    header.literalBytes = payload.size() - instance.clauses.size() * sizeof(uint32_t);
+    header.checksum = fnv1a(payload.data(), payload.size());
+
+    ofstream file(fileName, ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(payload.data()),
+               static_cast<streamsize>(payload.size()));
+    if (!file) {
+        throw runtime_error("Error: cannot write binary CNF file: " + fileName);
+    }
+    return sizeof(header) + payload.size();
+}
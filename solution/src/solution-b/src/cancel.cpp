@@ -0,0 +1,21 @@
+#include "cancel.h"
+
+volatile std::sig_atomic_t Cancel::stopFlag = 0;
+thread_local const Timer *Cancel::clock = nullptr;
+thread_local double Cancel::timeLimit = 0.0;
+
+void Cancel::stop() { stopFlag = 1; }
+
+void Cancel::setTimeLimit(const Timer &clock, double seconds) {
+    Cancel::clock = &clock;
+    timeLimit = seconds;
+}
+
+bool Cancel::requested() { return stopFlag != 0; }
+
+bool Cancel::expired() {
+    if (stopFlag != 0) {
+        return true;
+    }
+    return clock != nullptr && clock->getTime() >= timeLimit;
+}
@@ -1,4 +1,5 @@
 #include "dimacs_parser.h"
+#include "binary_cnf.h"
 
 #include <fstream>
 #include <iostream>
@@ -9,12 +10,19 @@
 
 using namespace std;
 
+// Binary CNF files are recognized by their magic number and loaded by loadBinaryCNF
 SATInstance parseCNFFile(const string &fileName) {
+    if (isBinaryCNF(fileName)) {
+        return loadBinaryCNF(fileName);
+    }
     ifstream file(fileName);
     if (!file.is_open()) {
         throw runtime_error("Error: DIMACS file not found: " + fileName);
     }
+    return parseCNF(file);
+}
 
+SATInstance parseCNF(istream &file) {
     string line;
     vector<string> tokens;
 
@@ -71,6 +79,7 @@ SATInstance parseCNFFile(const string &fileName) {
         }
 
         // Add clause to SATInstance
+        satInstance.fingerprint.add(clause);
         satInstance.addClause(clause);
         clause.clear();
     }
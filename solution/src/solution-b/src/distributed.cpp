@@ -0,0 +1,388 @@
+#include "distributed.h"
+#include "cancel.h"
+#include "dimacs_parser.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+// How often the coordinator looks at the clock and the stop flag while no worker writes
+static const int POLL_MS = 100;
+// Seconds a worker searches before it looks for shared clauses and stop requests
+static const double SLICE_SECONDS = 0.1;
+// Seconds a worker keeps trying to reach a coordinator that is not up yet
+static const double CONNECT_SECONDS = 10.0;
+
+static string literalLine(const string &prefix, const vector<int> &literals) {
+    string line = prefix;
+    for (int lit : literals) {
+        line += " " + to_string(lit);
+    }
+    return line + " 0\n";
+}
+
+// Literals of a line up to its terminating 0, after the words already read from tokens
+static vector<int> readLiterals(istringstream &tokens) {
+    vector<int> literals;
+    int lit;
+    while (tokens >> lit && lit != 0) {
+        literals.push_back(lit);
+    }
+    return literals;
+}
+
+/*{{{ Coordinator */
+Coordinator::Peer::Peer(int fd)
+    : fd(fd), reader(fd), sent(0), busy(false), stopping(false), cube() {}
+
+Coordinator::Coordinator(const SATInstance &instance, const DistributedOptions &options)
+    : instance(instance), options(options), nextId(0) {
+    int numVars = instance.getNumVars();
+    for (const Clause &clause : instance.clauses) {
+        for (int lit : clause.literals) {
+            numVars = max(numVars, abs(lit));
+        }
+    }
+    ostringstream text;
+    text << "p cnf " << numVars << " " << instance.clauses.size() << "\n";
+    vector<size_t> occurrences(static_cast<size_t>(numVars) + 1, 0);
+    for (const Clause &clause : instance.clauses) {
+        for (int lit : clause.literals) {
+            text << lit << " ";
+            occurrences[static_cast<size_t>(abs(lit))]++;
+        }
+        text << "0\n";
+    }
+    formula = text.str();
+
+    for (int var = 1; var <= numVars; var++) {
+        if (occurrences[static_cast<size_t>(var)] > 0) {
+            frequent.push_back(var);
+        }
+    }
+    stable_sort(frequent.begin(), frequent.end(), [&](int a, int b) {
+        return occurrences[static_cast<size_t>(a)] > occurrences[static_cast<size_t>(b)];
+    });
+}
+
+// Every sign combination of the most frequent variables
+void Coordinator::initialCubes() {
+    size_t depth = min(options.cubeVars, frequent.size());
+    for (uint64_t signs = 0; signs < (uint64_t(1) << depth); signs++) {
+        Cube cube = {nextId++, {}};
+        for (size_t i = 0; i < depth; i++) {
+            cube.literals.push_back((signs >> i) & 1 ? -frequent[i] : frequent[i]);
+        }
+        pending.push_back(cube);
+    }
+}
+
+// Replaces cube by its two halves on lit's variable, or on the most frequent variable the cube
+// leaves free if the worker had not decided anything
+void Coordinator::split(const Cube &cube, int lit, Stats &stats) {
+    auto fixed = [&cube](int var) {
+        return any_of(cube.literals.begin(), cube.literals.end(),
+                      [var](int l) { return abs(l) == var; });
+    };
+    if (lit == 0 || fixed(abs(lit))) {
+        auto free = find_if(frequent.begin(), frequent.end(), [&](int var) { return !fixed(var); });
+        lit = free == frequent.end() ? 0 : *free;
+    }
+    if (lit == 0) {
+        pending.push_front({nextId++, cube.literals}); // Nothing left to split on
+        return;
+    }
+    for (int half : {-lit, lit}) {
+        Cube part = {nextId++, cube.literals};
+        part.literals.push_back(half);
+        pending.push_front(part);
+    }
+    stats.cubeSplits++;
+}
+
+// Messages are queued and written as the socket takes them, so that a worker busy writing its
+// own clauses can never block the coordinator
+void Coordinator::send(Peer &peer, const string &message) { peer.outbox += message; }
+
+void Coordinator::flush(Peer &peer) {
+    while (peer.sent < peer.outbox.size()) {
+        ssize_t n = ::send(peer.fd, peer.outbox.data() + peer.sent, peer.outbox.size() - peer.sent,
+                           MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (n <= 0) {
+            shutdown(peer.fd, SHUT_RDWR); // Noticed as a closed connection by the next poll
+            peer.outbox.clear();
+            peer.sent = 0;
+            return;
+        }
+        peer.sent += static_cast<size_t>(n);
+    }
+    if (peer.sent == peer.outbox.size() || peer.sent > peer.outbox.size() / 2) {
+        peer.outbox.erase(0, peer.sent);
+        peer.sent = 0;
+    }
+}
+
+bool Coordinator::handle(Peer &peer, const string &line, Assignment &model, Stats &stats) {
+    istringstream tokens(line);
+    string kind;
+    tokens >> kind;
+    if (kind == "learnt") {
+        string clause = literalLine("clause", readLiterals(tokens));
+        for (auto &other : peers) {
+            if (other.get() != &peer) {
+                send(*other, clause);
+            }
+        }
+        stats.sharedClauses++;
+        return false;
+    }
+    uint64_t id;
+    string verdict;
+    if (kind != "result" || !(tokens >> id >> verdict) || !peer.busy || id != peer.cube.id) {
+        return false; // Not the cube the worker is on
+    }
+    peer.busy = false;
+    if (verdict == "SAT") {
+        for (int lit : readLiterals(tokens)) {
+            model[abs(lit)] = lit > 0 ? 1 : -1;
+        }
+        return true;
+    }
+    if (verdict == "UNSAT") {
+        stats.cubesSolved++;
+    } else {
+        int lit = 0;
+        tokens >> lit;
+        split(peer.cube, lit, stats);
+    }
+    return false;
+}
+
+void Coordinator::dispatch() {
+    for (auto &peer : peers) {
+        if (peer->busy || pending.empty()) {
+            continue;
+        }
+        peer->cube = pending.front();
+        pending.pop_front();
+        peer->busy = true;
+        peer->stopping = false;
+        peer->clock.start();
+        send(*peer, literalLine("cube " + to_string(peer->cube.id), peer->cube.literals));
+    }
+}
+
+// With an idle worker and nothing queued, stops the cube that has run longest to split it
+void Coordinator::rebalance() {
+    bool idle = any_of(peers.begin(), peers.end(), [](const auto &peer) { return !peer->busy; });
+    if (!idle || !pending.empty()) {
+        return;
+    }
+    Peer *slowest = nullptr;
+    for (auto &peer : peers) {
+        if (peer->busy && !peer->stopping && peer->clock.getTime() >= options.splitAfter &&
+            (slowest == nullptr || peer->clock.getTime() > slowest->clock.getTime())) {
+            slowest = peer.get();
+        }
+    }
+    if (slowest != nullptr) {
+        slowest->stopping = true;
+        send(*slowest, "stop " + to_string(slowest->cube.id) + "\n");
+    }
+}
+
+int Coordinator::run(SolveResult &result, Assignment &model, Stats &stats) {
+    int listener = listenOn(options.address);
+    if (listener < 0) {
+        cerr << "Error: cannot listen on " << options.address << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    initialCubes();
+    result = SolveResult::UNKNOWN;
+
+    while (!Cancel::expired()) {
+        vector<pollfd> ready = {{listener, POLLIN, 0}};
+        for (auto &peer : peers) {
+            short events = peer->outbox.empty() ? POLLIN : POLLIN | POLLOUT;
+            ready.push_back({peer->fd, events, 0});
+        }
+        if (poll(ready.data(), ready.size(), POLL_MS) > 0 && (ready[0].revents & POLLIN)) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                peers.push_back(make_unique<Peer>(fd));
+                send(*peers.back(), "formula\n" + formula + "end\n");
+            }
+        }
+
+        bool found = false;
+        for (auto &peer : peers) {
+            string line;
+            while (!found && peer->reader.poll(line)) {
+                found = handle(*peer, line, model, stats);
+            }
+        }
+        if (found) {
+            result = SolveResult::SAT;
+            break;
+        }
+        // A worker that left gives its cube back
+        erase_if(peers, [this](const auto &peer) {
+            if (!peer->reader.done()) {
+                return false;
+            }
+            if (peer->busy) {
+                pending.push_front(peer->cube);
+            }
+            close(peer->fd);
+            return true;
+        });
+
+        bool working = any_of(peers.begin(), peers.end(), [](const auto &p) { return p->busy; });
+        if (pending.empty() && !working) {
+            result = SolveResult::UNSAT; // Every cube was refuted
+            break;
+        }
+        dispatch();
+        rebalance();
+        for (auto &peer : peers) {
+            flush(*peer);
+        }
+    }
+
+    for (auto &peer : peers) {
+        sendAll(peer->fd, peer->outbox.substr(peer->sent) + "quit\n");
+        close(peer->fd);
+    }
+    peers.clear();
+    close(listener);
+    removeAddress(options.address);
+    return 0;
+} /*}}}*/
+
+/*{{{ Worker */
+Worker::Worker(const DistributedOptions &options)
+    : options(options), fd(-1), instance(0, 0), numVars(0), quitting(false) {}
+
+// Reads the formula that follows a "formula" line and starts a solver on it
+void Worker::load() {
+    string text, line;
+    while (reader->next(line) && line != "end") {
+        text += line + "\n";
+    }
+    istringstream input(text);
+    instance = parseCNF(input);
+    numVars = instance.getNumVars();
+    solver = Solver();
+    solver.setVivifyBudget(options.vivifyBudget);
+    solver.setChronoThreshold(options.chronoThreshold);
+    solver.setMemLimit(options.memLimit);
+    solver.setPureLiterals(options.pureLiterals);
+    solver.setDetectAmo(options.detectAmo);
+    solver.setExportLimit(options.shareLimit);
+    solver.setInstance(instance);
+}
+
+void Worker::share() {
+    string lines;
+    for (const vector<int> &clause : solver.takeExported()) {
+        lines += literalLine("learnt", clause);
+    }
+    if (!lines.empty()) {
+        sendAll(fd, lines);
+    }
+}
+
+bool Worker::poll(uint64_t id, int branch) {
+    string line;
+    while (reader->poll(line)) {
+        istringstream tokens(line);
+        string kind;
+        tokens >> kind;
+        uint64_t target;
+        if (kind == "clause") {
+            solver.importLearnt(readLiterals(tokens));
+        } else if (kind == "stop" && tokens >> target && target == id) {
+            sendAll(fd, "result " + to_string(id) + " UNKNOWN " + to_string(branch) + "\n");
+            return true;
+        } else if (kind == "quit") {
+            quitting = true;
+            return true;
+        }
+    }
+    return reader->done();
+}
+
+// Searches in slices, sharing learned clauses and taking in those of the others in between
+void Worker::solveCube(uint64_t id, const vector<int> &cube) {
+    while (true) {
+        slice.start();
+        Cancel::setTimeLimit(slice, SLICE_SECONDS);
+        SolveResult result = solver.solve(cube);
+        int branch = solver.branchLiteral(); // Before new clauses move the solver to the root
+        share();
+        if (result == SolveResult::SAT) {
+            vector<int> literals;
+            for (const auto &[var, value] : solver.getAssignment()) {
+                if (var <= numVars && value != 0) {
+                    literals.push_back(value == 1 ? var : -var);
+                }
+            }
+            sendAll(fd, literalLine("result " + to_string(id) + " SAT", literals));
+            return;
+        }
+        if (result == SolveResult::UNSAT) {
+            sendAll(fd, "result " + to_string(id) + " UNSAT\n");
+            return;
+        }
+        if (Cancel::requested() || poll(id, branch)) {
+            return;
+        }
+    }
+}
+
+int Worker::run() {
+    Timer waited;
+    waited.start();
+    while ((fd = connectTo(options.address)) < 0) {
+        if (Cancel::requested() || waited.getTime() > CONNECT_SECONDS) {
+            cerr << "Error: cannot connect to " << options.address << ": " << strerror(errno)
+                 << endl;
+            return 1;
+        }
+        this_thread::sleep_for(chrono::milliseconds(POLL_MS));
+    }
+    reader = make_unique<LineReader>(fd);
+
+    string line;
+    while (!quitting && reader->next(line)) {
+        istringstream tokens(line);
+        string kind;
+        tokens >> kind;
+        uint64_t id;
+        if (kind == "formula") {
+            load();
+        } else if (kind == "clause") {
+            solver.importLearnt(readLiterals(tokens));
+        } else if (kind == "cube" && tokens >> id) {
+            solveCube(id, readLiterals(tokens));
+        } else if (kind == "quit") {
+            break;
+        }
+    }
+    close(fd);
+    return 0;
+} /*}}}*/
@@ -1,12 +1,34 @@
 #include "dpll.h"
 #include "sat_instance.h"
+#include "timer.h"
+#include "trace.h"
 #include "types.h"
 
 using namespace std;
 
-Solver::Solver() : instance() {}
+Solver::Solver()
+    : instance(), vivifyBudget(0), chronoThreshold(-1), memLimit(0), pureLiterals(false),
+      detectAmo(true), initialized(false), ok(true), exportLimit(0), conflictClause(NO_REASON),
+      numLearnts(0), maxLearnts(0), clauseBytes(0), lastVivify(0) {}
 void Solver::setInstance(SATInstance &instance) { this->instance = &instance; }
+void Solver::setPhases(const vector<int> &phases) {
+    this->phases = phases;
+    for (size_t var = 1; var < min(phases.size(), savedPhase.size()); var++) {
+        if (phases[var] != 0) {
+            savedPhase[var] = phases[var]; // Already initialized: later decisions follow them
+        }
+    }
+}
+void Solver::setVivifyBudget(uint64_t budget) { vivifyBudget = budget; }
+void Solver::setChronoThreshold(int threshold) { chronoThreshold = threshold; }
+void Solver::setMemLimit(size_t bytes) { memLimit = bytes; }
+void Solver::setPureLiterals(bool enabled) { pureLiterals = enabled; }
+void Solver::setDetectAmo(bool enabled) { detectAmo = enabled; }
+void Solver::setExportLimit(size_t maxSize) { exportLimit = maxSize; }
+
+static size_t litIndex(int lit) { return 2 * static_cast<size_t>(abs(lit)) + (lit < 0 ? 1u : 0u); }
 Assignment Solver::getAssignment() { return instance->assignment; }
+Stats &Solver::getStats() { return stats; }
 
 
 /*{{{ Debugging print functions */
@@ -48,6 +70,7 @@ bool Solver::propagate() {
         // Pop the first of propQueue, this is a literal we forced to be true
         int p = instance->propQueue.front();
         instance->propQueue.pop();
+        stats.propagations++;
         int negP = -p; // This literal is forced to be false
 
         // We process all clauses that are watching -p because -p is false
@@ -61,6 +84,9 @@ bool Solver::propagate() {
             // If there is no other watched literal, we conflict since negP is definitely false
             optional<size_t> otherWatchIdxOpt = (watchId == 0 ? clause.watch2 : clause.watch1);
             if (!otherWatchIdxOpt.has_value()) {
+                stats.conflicts++;
+                conflictClause = ci;
+                TRACE_EVENT(Conflict, decisionLevel(), clause.literals.size(), trail.size());
                 return false;
             }
 
@@ -98,148 +124,866 @@ bool Solver::propagate() {
                 // Otherwise, there is a conflict
 
                 if (instance->isFalse(otherLit)) {
+                    stats.conflicts++;
+                    conflictClause = ci;
+                    TRACE_EVENT(Conflict, decisionLevel(), clause.literals.size(), trail.size());
                     return false; // conflict detected
                 } else if (instance->assignment[abs(otherLit)] == 0) {
-                    // We can guarantee that the otherLit has to be true
-                    int val = (otherLit > 0) ? 1 : -1;
-                    instance->assignment[abs(otherLit)] = val;
-                    instance->propQueue.push(otherLit);
+                    // We can guarantee that the otherLit has to be true. It is implied at the
+                    // highest level among the false literals, which may be below the current
+                    // level; watch that literal so both watches are undone together.
+                    size_t highest = *(watchId == 0 ? clause.watch1 : clause.watch2);
+                    for (size_t k = 0; k < clause.literals.size(); k++) {
+                        if (k != otherWatchIdx &&
+                            level[static_cast<size_t>(abs(clause.literals[k]))] >
+                                level[static_cast<size_t>(abs(clause.literals[highest]))]) {
+                            highest = k;
+                        }
+                    }
+                    if (highest != *(watchId == 0 ? clause.watch1 : clause.watch2)) {
+                        moveWatch(ci, watchId, highest);
+                    }
+                    assign(otherLit, level[static_cast<size_t>(abs(clause.literals[highest]))], ci);
                 }
             }
         }
+
+        if (!amos.empty() && !propagateAmo(p)) {
+            return false;
+        }
     }
     return true;
-} /*}}}*/
+}
 
-/*{{{ Pure Literal Elimination*/
-bool Solver::pureLiteralElimination() {
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        unordered_map<int, int> polarities;
-        // Count appearances of each literal (only if the variable is unassigned).
-        for (const auto &clause : instance->clauses) {
-            for (int lit : clause.literals) {
-                if (instance->assignment[abs(lit)] != 0) {
-                    continue;
-                }
-                if (lit > 0) {
-                    if (polarities[lit] == 0)
-                        polarities[lit] = 1;
-                    else if (polarities[lit] == -1)
-                        polarities[lit] = 2;
-                } else {
-                    if (polarities[-lit] == 0)
-                        polarities[-lit] = -1;
-                    else if (polarities[-lit] == 1)
-                        polarities[-lit] = 2;
-                }
+// p just became true, so every other literal of its at-most-one constraints must be false. Two
+// true literals are a conflict, explained by the binary clause the constraint stands for; that
+// clause only lives in amoConflict, so the pairwise encoding never returns to the database.
+bool Solver::propagateAmo(int p) {
+    for (size_t a : amosOf[litIndex(p)]) {
+        for (int lit : amos[a]) {
+            if (lit == p || instance->isFalse(lit)) {
+                continue;
             }
-        }
-        // For each variable that is pure, assign it.
-        for (const auto &[key, value] : polarities) {
-            if (value == 1) {
-                instance->assignment[key] = 1;
-                instance->propQueue.push(key);
-                changed = true;
-            } else if (value == -1) {
-                instance->assignment[key] = -1;
-                instance->propQueue.push(-key);
-                changed = true;
+            if (instance->isTrue(lit)) {
+                stats.conflicts++;
+                conflictClause = AMO_REASON;
+                amoConflict = {-p, -lit};
+                TRACE_EVENT(Conflict, decisionLevel(), 2, trail.size());
+                return false;
             }
+            trigger[static_cast<size_t>(abs(lit))] = p;
+            assign(-lit, level[static_cast<size_t>(abs(p))], AMO_REASON);
         }
-        if (changed && !propagate())
-            return false;
     }
     return true;
+}
+
+// Replaces pairwise at-most-one encodings of three or more literals by native constraints
+void Solver::initAmo(int numVars) {
+    const size_t MIN_AMO_SIZE = 3;
+    size_t before = instance->clauses.size();
+    amos = detectAmo ? extractAtMostOnes(instance->clauses, MIN_AMO_SIZE)
+                     : vector<vector<int>>();
+    stats.amoConstraints = amos.size();
+    stats.amoClausesRemoved = before - instance->clauses.size();
+
+    amosOf.assign(2 * static_cast<size_t>(numVars) + 2, {});
+    for (size_t a = 0; a < amos.size(); a++) {
+        for (int lit : amos[a]) {
+            amosOf[litIndex(lit)].push_back(a);
+        }
+    }
+    trigger.assign(static_cast<size_t>(numVars) + 1, 0);
+} /*}}}*/
+
+/*{{{ Pure Literal Elimination*/
+// Branches on a literal that is pure in the unsatisfied problem clauses, if there is one. It is
+// a decision, so learned clauses stay implied by the formula; it satisfies every clause it is in
+// and cannot falsify one, so it never needs to be flipped for the problem clauses.
+int Solver::pureLiteralElimination() {
+    if (!occurrences.enabled()) {
+        return 0;
+    }
+    return occurrences.nextPure(instance->assignment);
 } /*}}}*/
 
 /*{{{ Choose Literal */
-int Solver::chooseLiteral() {
-    unordered_map<int, double> score;
-    // Assign higher weight to literals in shorter clauses
+// Seeds the branching order with Jeroslow-Wang scores: a higher weight for literals in shorter
+// clauses. The variable score is the initial VSIDS activity and the better-scoring polarity is
+// the initial phase, unless a phase hint was given. An at-most-one constraint over k literals
+// counts as the k - 1 binary clauses (-lit -other) per literal that it replaced, since its
+// variables may occur in no remaining clause and must still be decided.
+void Solver::initOrder(int numVars) {
+    vector<double> score(2 * static_cast<size_t>(numVars) + 2, 0.0);
+    auto index = [](int lit) { return 2 * static_cast<size_t>(abs(lit)) + (lit < 0 ? 1u : 0u); };
     for (const auto &clause : instance->clauses) {
         double weight = pow(2.0, -static_cast<double>(clause.literals.size()));
         for (int lit : clause.literals) {
-            score[lit] += weight;
+            score[index(lit)] += weight;
         }
     }
-    // Pick the literal with the best score
-    int bestLiteral = 0;
-    double bestScore = -1.0;
-    for (const auto &[lit, s] : score) {
-        if (s > bestScore && instance->assignment[abs(lit)] == 0) {
-            bestScore = s;
-            bestLiteral = lit;
+    for (const auto &amo : amos) {
+        for (int lit : amo) {
+            score[index(-lit)] += 0.25 * static_cast<double>(amo.size() - 1);
         }
     }
-    return bestLiteral; // 0 if all are empty or not found
+
+    order.init(numVars);
+    savedPhase.assign(static_cast<size_t>(numVars) + 1, 1);
+    for (int var = 1; var <= numVars; var++) {
+        double pos = score[index(var)], neg = score[index(-var)];
+        if (pos + neg == 0.0) {
+            continue; // Not in any clause or constraint, never needs a decision
+        }
+        size_t v = static_cast<size_t>(var);
+        savedPhase[v] = v < phases.size() && phases[v] != 0 ? phases[v] : (neg > pos ? -1 : 1);
+        order.setActivity(var, pos + neg);
+        order.insert(var);
+    }
+}
+
+// Picks the unassigned variable with the highest activity, in its saved phase
+int Solver::chooseLiteral() {
+    while (!order.empty()) {
+        int var = order.removeMax();
+        if (instance->assignment[var] == 0) {
+            int lit = savedPhase[static_cast<size_t>(var)] * var;
+            TRACE_EVENT(Decide, decisionLevel(), lit, 0);
+            return lit;
+        }
+    }
+    return 0; // Every variable that occurs in a clause is assigned
 }
 /*}}}*/
 
-/*{{{ DPLL Loop*/
-bool Solver::dpll() {
-    // First, perform pure literal elimination and propagate any unit clauses.
-    /* if (!pureLiteralElimination()) { */
-    /*     return false; */
-    /* } */
-    if (!propagate()) {
-        return false;
+/*{{{ Trail */
+int Solver::decisionLevel() const { return static_cast<int>(trailLim.size()); }
+
+void Solver::newDecisionLevel() { trailLim.push_back(trail.size()); }
+
+// Makes lit true at decision level lvl, implied by clause from, and queues it for propagation
+void Solver::assign(int lit, int lvl, size_t from) {
+    size_t var = static_cast<size_t>(abs(lit));
+    instance->assignment[abs(lit)] = lit > 0 ? 1 : -1;
+    level[var] = lvl;
+    reason[var] = from;
+    trail.push_back(lit);
+    instance->propQueue.push(lit);
+    if (occurrences.enabled()) {
+        occurrences.onAssign(lit);
+    }
+}
+
+// Moves watch watchId (0 or 1) of clause ci onto the literal at index k
+void Solver::moveWatch(size_t ci, int watchId, size_t k) {
+    Clause &clause = instance->clauses[ci];
+    optional<size_t> &watch = watchId == 0 ? clause.watch1 : clause.watch2;
+    instance->watchers[clause.literals[*watch]].erase({ci, watchId});
+    watch = k;
+    instance->watchers[clause.literals[k]].insert({ci, watchId});
+}
+
+// Undoes every assignment above level target. Literals that were implied out of order at or
+// below target stay on the trail and are propagated again, since clauses they falsified may
+// have lost the true literal that was satisfying them.
+void Solver::backtrack(int target) {
+    if (decisionLevel() <= target) {
+        return;
+    }
+    vector<int> kept;
+    for (size_t i = trailLim[static_cast<size_t>(target)]; i < trail.size(); i++) {
+        int lit = trail[i];
+        size_t var = static_cast<size_t>(abs(lit));
+        if (level[var] <= target) {
+            kept.push_back(lit);
+        } else {
+            instance->assignment[abs(lit)] = 0;
+            reason[var] = NO_REASON;
+            savedPhase[var] = lit > 0 ? 1 : -1;
+            order.insert(abs(lit));
+            if (occurrences.enabled()) {
+                occurrences.onUnassign(lit);
+            }
+        }
+    }
+    trail.resize(trailLim[static_cast<size_t>(target)]);
+    trailLim.resize(static_cast<size_t>(target));
+
+    instance->propQueue = queue<int>();
+    for (int lit : kept) {
+        trail.push_back(lit);
+        instance->propQueue.push(lit);
+    }
+}
+
+// Assigns the unit clauses at the root and propagates them. Returns false if that already
+// gives a conflict or the formula has an empty clause.
+bool Solver::assignUnits() {
+    for (size_t ci = 0; ci < instance->clauses.size(); ci++) {
+        const Clause &clause = instance->clauses[ci];
+        if (clause.literals.empty()) {
+            return false;
+        }
+        if (clause.literals.size() == 1) {
+            int lit = clause.literals[0];
+            if (instance->isFalse(lit)) {
+                return false;
+            }
+            if (!instance->isTrue(lit)) {
+                assign(lit, 0, ci);
+            }
+        }
+    }
+    return propagate();
+} /*}}}*/
+
+/*{{{ Conflict Analysis */
+// Literals of the clause that implied p, or of the conflict clause when p is 0. A literal
+// implied by an at-most-one constraint is explained by the binary clause (p -trigger).
+const vector<int> &Solver::explain(size_t from, int p) {
+    if (from != AMO_REASON) {
+        return instance->clauses[from].literals;
     }
+    if (p == 0) {
+        return amoConflict;
+    }
+    explanation = {p, -trigger[static_cast<size_t>(abs(p))]};
+    return explanation;
+}
 
-    // Check if all variables are assigned.
-    bool complete = true;
-    for (int v = 1; v <= instance->getNumVars(); v++) {
-        if (instance->assignment[v] == 0) {
-            complete = false;
+// First-UIP analysis of conflictClause, run once the trail is back at the conflict's level.
+// Literals are compared by their own level rather than their trail position, since
+// chronological backtracking leaves out-of-order literals on the trail. Returns the learned
+// clause with the asserting literal first and the highest-level remaining literal second.
+// expanded is false if the conflict clause already had a single literal at conflictLevel.
+vector<int> Solver::analyze(int conflictLevel, bool &expanded) {
+    vector<int> learnt = {0};
+    int pathCount = 0;
+    int p = 0;
+    size_t ci = conflictClause;
+    size_t index = trail.size();
+    expanded = false;
+
+    while (true) {
+        for (int q : explain(ci, p)) {
+            size_t var = static_cast<size_t>(abs(q));
+            if (q == p || seen[var] || level[var] == 0) {
+                continue;
+            }
+            seen[var] = true;
+            order.bump(abs(q));
+            if (level[var] == conflictLevel) {
+                pathCount++;
+            } else {
+                learnt.push_back(q);
+            }
+        }
+
+        // Walk back to the most recent marked literal of the conflict level
+        do {
+            p = trail[--index];
+        } while (!seen[static_cast<size_t>(abs(p))] ||
+                 level[static_cast<size_t>(abs(p))] != conflictLevel);
+        seen[static_cast<size_t>(abs(p))] = false;
+
+        if (--pathCount == 0) {
             break;
         }
+        ci = reason[static_cast<size_t>(abs(p))];
+        expanded = true;
+    }
+    learnt[0] = -p;
+
+    size_t highest = 1;
+    for (size_t i = 1; i < learnt.size(); i++) {
+        seen[static_cast<size_t>(abs(learnt[i]))] = false;
+        if (level[static_cast<size_t>(abs(learnt[i]))] >
+            level[static_cast<size_t>(abs(learnt[highest]))]) {
+            highest = i;
+        }
+    }
+    if (learnt.size() > 1) {
+        swap(learnt[1], learnt[highest]);
+    }
+    return learnt;
+}
+
+// Learns from the conflict in conflictClause and backtracks so that the learned clause
+// asserts its first literal. Backjumps longer than chronoThreshold only go back one level and
+// keep the rest of the trail; the asserted literal is then placed out of order at its real
+// level. Returns false if the conflict holds at the root.
+bool Solver::resolveConflict() {
+    int conflictLevel = 0;
+    for (int lit : explain(conflictClause, 0)) {
+        conflictLevel = max(conflictLevel, level[static_cast<size_t>(abs(lit))]);
+    }
+    if (conflictLevel == 0) {
+        return false;
     }
+    // With out-of-order literals the conflict can lie entirely below the current level
+    backtrack(conflictLevel);
 
-    if (complete) {
-        return true;
+    bool expanded;
+    vector<int> learnt = analyze(conflictLevel, expanded);
+    order.decay();
+    int backjumpLevel = learnt.size() > 1 ? level[static_cast<size_t>(abs(learnt[1]))] : 0;
+
+    size_t from = conflictClause;
+    if (expanded) {
+        from = learn(learnt);
+    } else if (from == AMO_REASON) {
+        // The violated constraint asserts the literal itself, forced by its other true literal
+        int other = amoConflict[0] == learnt[0] ? amoConflict[1] : amoConflict[0];
+        trigger[static_cast<size_t>(abs(learnt[0]))] = -other;
+    } else if (learnt.size() > 1) {
+        // A missed implication: the conflict clause itself asserts its only literal at
+        // conflictLevel, so make it watch that literal and the highest remaining one
+        Clause &clause = instance->clauses[from];
+        auto index = [&](int lit) {
+            return static_cast<size_t>(find(clause.literals.begin(), clause.literals.end(), lit) -
+                                       clause.literals.begin());
+        };
+        size_t first = index(learnt[0]), second = index(learnt[1]);
+        if (*clause.watch1 != first && *clause.watch2 != first) {
+            moveWatch(from, *clause.watch1 == second ? 1 : 0, first);
+        }
+        if (*clause.watch1 != second && *clause.watch2 != second) {
+            moveWatch(from, *clause.watch1 == first ? 1 : 0, second);
+        }
     }
 
-    // Choose a literal to branch on.
-    int lit = chooseLiteral();
+    int target = backjumpLevel;
+    if (chronoThreshold >= 0 && conflictLevel - backjumpLevel > chronoThreshold) {
+        target = conflictLevel - 1;
+        stats.chronoBacktracks++;
+        stats.trailKept += trailLim[static_cast<size_t>(target)] -
+                           trailLim[static_cast<size_t>(backjumpLevel)];
+    }
+    TRACE_EVENT(Learn, conflictLevel, learnt.size(), conflictLevel - target);
+    backtrack(target);
+    assign(learnt[0], backjumpLevel, from);
+    return true;
+} /*}}}*/
 
-    if (lit == 0) {
-        cout << "No literal found... This indicates a bug and should never happen" << endl;
-        return false; // no literal found
+/*{{{ Learned Clauses */
+// Appends a clause watching its first two literals and returns its index
+size_t Solver::addClause(const vector<int> &literals, bool learnt, int lbd) {
+    size_t ci = instance->clauses.size();
+    instance->clauses.emplace_back(literals, learnt, lbd);
+    const Clause &clause = instance->clauses.back();
+    if (clause.watch1.has_value()) {
+        instance->watchers[clause.literals[*clause.watch1]].insert({ci, 0});
+    }
+    if (clause.watch2.has_value()) {
+        instance->watchers[clause.literals[*clause.watch2]].insert({ci, 1});
     }
+    clauseBytes += footprint(clause);
+    return ci;
+}
 
-    // Save state for backtracking.
-    auto assignment_backup = instance->assignment;
-    queue<int> propQueue_backup = instance->propQueue;
+// Adds a learned clause (asserting literal first) and returns its index
+size_t Solver::learn(const vector<int> &literals) {
+    set<int> levels;
+    for (int lit : literals) {
+        levels.insert(level[static_cast<size_t>(abs(lit))]);
+    }
 
-    // Branch with the chosen literal set to true.
-    instance->assignment[abs(lit)] = lit > 0 ? 1 : -1;
-    instance->propQueue.push(lit);
-    if (propagate() && dpll()) {
-        return true;
+    size_t ci = addClause(literals, true, static_cast<int>(levels.size()));
+    numLearnts++;
+    stats.learnedClauses++;
+    stats.learnedLiterals += literals.size();
+    if (literals.size() <= exportLimit) {
+        exported.push_back(literals);
     }
+    return ci;
+}
 
-    // Restore state
-    instance->assignment = assignment_backup;
-    instance->propQueue = propQueue_backup;
+// Deletes the learned clauses vivification found implied, and the worse half of the others by
+// LBD, then length, or all of them when aggressive. Glue clauses (LBD <= 2) are always kept.
+// Only called at the root, where no reason is ever analyzed again.
+void Solver::reduceDB(bool aggressive) {
+    vector<bool> deleted(instance->clauses.size(), false);
+    for (size_t ci : implied) {
+        deleted[ci] = true;
+    }
+    size_t numDeleted = implied.size();
+    implied.clear();
 
-    // Try opposite assignment
-    instance->assignment[abs(lit)] = lit < 0 ? 1 : -1;
-    instance->propQueue.push(-lit);
+    vector<size_t> candidates;
+    for (size_t ci = 0; ci < instance->clauses.size(); ci++) {
+        const Clause &clause = instance->clauses[ci];
+        if (clause.learnt && clause.lbd > 2 && !deleted[ci]) {
+            candidates.push_back(ci);
+        }
+    }
+    sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        const Clause &x = instance->clauses[a], &y = instance->clauses[b];
+        if (x.lbd != y.lbd)
+            return x.lbd > y.lbd;
+        return x.literals.size() > y.literals.size();
+    });
 
-    if (propagate() && dpll()) {
-        return true;
+    size_t numWorse = aggressive ? candidates.size() : candidates.size() / 2;
+    for (size_t i = 0; i < numWorse; i++) {
+        deleted[candidates[i]] = true;
     }
+    numDeleted += numWorse;
 
-    // Restore state and return failure.
-    instance->assignment = assignment_backup;
-    instance->propQueue = propQueue_backup;
+    // Compact the database; clause indices shift, so the watchers are rebuilt
+    size_t kept = 0;
+    for (size_t ci = 0; ci < instance->clauses.size(); ci++) {
+        if (deleted[ci]) {
+            continue;
+        }
+        if (kept != ci) {
+            instance->clauses[kept] = move(instance->clauses[ci]);
+        }
+        kept++;
+    }
+    instance->clauses.erase(instance->clauses.begin() + static_cast<ptrdiff_t>(kept),
+                            instance->clauses.end());
+    for (int lit : trail) {
+        reason[static_cast<size_t>(abs(lit))] = NO_REASON;
+    }
+    instance->initWatchers();
+    countClauseBytes();
 
-    return false;
+    numLearnts -= numDeleted;
+    stats.deletedClauses += numDeleted;
+    if (!aggressive) {
+        maxLearnts += maxLearnts / 10;
+    }
+} /*}}}*/
+
+/*{{{ Memory Budget */
+// Rough sizes of the node-based containers, which dominate the footprint
+const size_t WATCH_BYTES = 48; // std::set node holding a (clause, watch) pair
+const size_t VAR_BYTES = 96;   // Assignment map node and the per-variable vectors
+
+size_t Solver::footprint(const Clause &clause) {
+    return sizeof(Clause) + clause.literals.capacity() * sizeof(int) + 2 * WATCH_BYTES;
+}
+
+void Solver::countClauseBytes() {
+    clauseBytes = instance->clauses.capacity() * sizeof(Clause);
+    for (const Clause &clause : instance->clauses) {
+        clauseBytes += footprint(clause) - sizeof(Clause);
+    }
+}
+
+// Estimated bytes held by the search; also tracks the peak for the stats
+size_t Solver::memoryUsage() {
+    size_t bytes = clauseBytes + level.size() * VAR_BYTES + trail.capacity() * sizeof(int);
+    stats.peakMemory = max(stats.peakMemory, bytes);
+    return bytes;
+}
+
+// Called when the search is over its memory limit: restarts, drops every learned clause that
+// is not glue, lowers the learned clause cap and releases the spare capacity. Returns false if
+// that does not free a quarter of the budget, since the search would only thrash on restarts.
+bool Solver::reclaimMemory() {
+    stats.memoryReductions++;
+    backtrack(0);
+    reduceDB(true);
+    maxLearnts = max(numLearnts, maxLearnts / 2);
+    instance->clauses.shrink_to_fit();
+    trail.shrink_to_fit();
+    countClauseBytes();
+    return memoryUsage() <= memLimit - memLimit / 4;
+} /*}}}*/
+
+/*{{{ Restarts */
+// Luby sequence 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ..., scaled to space out restarts
+static uint64_t luby(uint64_t x) {
+    uint64_t size = 1;
+    uint64_t seq = 0;
+    while (size < x + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+    return uint64_t(1) << seq;
+}
+
+void Solver::restart() {
+    backtrack(0);
+    stats.restarts++;
+    memoryUsage(); // Keeps the peak for the stats also without a memory limit
+    TRACE_EVENT(Restart, 0, stats.restarts, numLearnts);
+    if (numLearnts > maxLearnts) {
+        reduceDB();
+    }
+    if (vivifyBudget > 0) {
+        vivifyLearnts();
+    }
+} /*}}}*/
+
+/*{{{ DPLL Loop*/
+// Conflict-driven search: propagate, learn from each conflict and backjump, restart on the
+// Luby schedule, and otherwise branch on chooseLiteral().
+SolveResult Solver::dpll() {
+    const uint64_t RESTART_UNIT = 100;
+    const uint64_t CLOCK_INTERVAL = 64; // Conflicts between reads of the clock
+    uint64_t restartConflicts = stats.conflicts + RESTART_UNIT * luby(stats.restarts);
+    uint64_t clockConflicts = stats.conflicts;
+
+    while (true) {
+        if (Cancel::requested()) {
+            return SolveResult::UNKNOWN;
+        }
+        if (stats.conflicts >= clockConflicts) {
+            if (Cancel::expired()) {
+                return SolveResult::UNKNOWN;
+            }
+            clockConflicts = stats.conflicts + CLOCK_INTERVAL;
+        }
+
+        [[maybe_unused]] uint64_t propagated = stats.propagations;
+        bool consistent = propagate();
+        TRACE_EVENT(Propagate, decisionLevel(), stats.propagations - propagated, !consistent);
+        if (!consistent) {
+            if (!resolveConflict()) {
+                ok = false;
+                return SolveResult::UNSAT;
+            }
+            if (memLimit > 0 && memoryUsage() > memLimit && !reclaimMemory()) {
+                return SolveResult::UNKNOWN;
+            }
+            continue;
+        }
+
+        if (stats.conflicts >= restartConflicts) {
+            restart();
+            restartConflicts = stats.conflicts + RESTART_UNIT * luby(stats.restarts);
+            continue;
+        }
+
+        // Assumptions take the first levels; one that is already true gets an empty level
+        int lit = 0;
+        while (lit == 0 && static_cast<size_t>(decisionLevel()) < assumptions.size()) {
+            int p = assumptions[static_cast<size_t>(decisionLevel())];
+            if (instance->isFalse(p)) {
+                return SolveResult::UNSAT; // Implied false by the formula and earlier assumptions
+            }
+            if (instance->isTrue(p)) {
+                newDecisionLevel();
+            } else {
+                lit = p;
+            }
+        }
+        if (lit != 0) {
+            newDecisionLevel();
+            assign(lit, decisionLevel(), NO_REASON);
+            continue;
+        }
+
+        lit = pureLiteralElimination();
+        if (lit != 0) {
+            stats.pureLiterals++;
+            newDecisionLevel();
+            assign(lit, decisionLevel(), NO_REASON);
+            continue;
+        }
+
+        // Choose a literal to branch on; none left means every clause is satisfied
+        lit = chooseLiteral();
+        if (lit == 0) {
+            return SolveResult::SAT;
+        }
+        stats.decisions++;
+        newDecisionLevel();
+        assign(lit, decisionLevel(), NO_REASON);
+    }
+} /*}}}*/
+
+/*{{{ Vivification */
+// Learned clauses up to this LBD (tier 1, the glue clauses reduceDB keeps, and tier 2) are
+// vivified at restarts, on at most 1/VIVIFY_SHARE of the propagations since the last pass
+const int TIER2_LBD = 6;
+const uint64_t VIVIFY_SHARE = 10;
+
+// Probes a clause that is detached from the watchers: assigns the negation of its literals in
+// order with unit propagation and returns the literals that are still needed. Literals implied
+// false by the negated prefix are dropped, and once the prefix implies the next literal or a
+// conflict the rest of the clause is cut off. implied tells which of the two ended the probe;
+// then the clause follows from the others by unit propagation.
+vector<int> Solver::vivifyClause(const vector<int> &literals, bool &implied) {
+    vector<int> needed;
+    implied = false;
+    for (int lit : literals) {
+        if (instance->isTrue(lit)) {
+            needed.push_back(lit); // The negated prefix already implies lit
+            implied = true;
+            break;
+        }
+        if (instance->isFalse(lit)) {
+            continue;
+        }
+        needed.push_back(lit);
+        newDecisionLevel();
+        assign(-lit, decisionLevel(), NO_REASON);
+        if (!propagate()) {
+            break; // The negated prefix is already contradictory
+        }
+    }
+    return needed;
+}
+
+// Probes the candidate clauses at the root, in order, within budget propagations. Problem
+// clauses are only strengthened, never deleted: learned clauses may be deleted later, so
+// dropping an implied problem clause can lose propagation that nothing recovers. A learned
+// clause that its negated prefix implies is left detached in implied until reduceDB deletes
+// it. The probes leave the saved phases as they were, and new units are assigned at the root.
+void Solver::vivify(const vector<size_t> &candidates, uint64_t budget) {
+    uint64_t budgetEnd = stats.propagations + budget;
+    uint64_t conflictsBefore = stats.conflicts;
+    vector<int> phasesBefore = savedPhase;
+    vector<size_t> units;
+
+    for (size_t ci : candidates) {
+        if (stats.propagations >= budgetEnd) {
+            break;
+        }
+        // Detach the clause so it cannot be used to justify itself. Probing may grow the
+        // database, so the clause is only looked up again afterwards.
+        vector<int> literals = instance->clauses[ci].literals;
+        instance->watchers[literals[*instance->clauses[ci].watch1]].erase({ci, 0});
+        instance->watchers[literals[*instance->clauses[ci].watch2]].erase({ci, 1});
+
+        bool redundant;
+        vector<int> needed = vivifyClause(literals, redundant);
+        backtrack(0);
+
+        Clause &clause = instance->clauses[ci];
+        clause.vivified = true;
+        if (redundant && clause.learnt) {
+            implied.push_back(ci);
+            stats.vivifiedDeleted++;
+            continue;
+        }
+        if (needed.size() < clause.literals.size()) {
+            size_t removed = clause.literals.size() - needed.size();
+            stats.vivifiedLiterals += removed;
+            stats.vivifiedClauses++;
+            if (clause.learnt) {
+                stats.learnedLiterals -= removed; // So AvgLearnedLength shows the shorter clauses
+            }
+            clauseBytes -= footprint(clause);
+            int lbd = min(clause.lbd, static_cast<int>(needed.size()));
+            clause = Clause(needed, clause.learnt, lbd);
+            clause.vivified = true;
+            clauseBytes += footprint(clause);
+            if (needed.size() == 1) {
+                units.push_back(ci);
+            }
+        }
+        if (clause.watch1.has_value()) {
+            instance->watchers[clause.literals[*clause.watch1]].insert({ci, 0});
+        }
+        if (clause.watch2.has_value()) {
+            instance->watchers[clause.literals[*clause.watch2]].insert({ci, 1});
+        }
+    }
+    stats.conflicts = conflictsBefore; // Probe conflicts are not search conflicts
+    savedPhase = phasesBefore;
+    lastVivify = stats.propagations;
+
+    // The root was propagated before, so a new unit cannot be false there
+    for (size_t ci : units) {
+        int lit = instance->clauses[ci].literals[0];
+        if (!instance->isTrue(lit)) {
+            assign(lit, 0, ci);
+        }
+    }
+}
+
+// Longer clauses cost the most per propagate() visit, so they are probed first
+void Solver::vivifyProblem() {
+    vector<size_t> candidates;
+    for (size_t ci = 0; ci < instance->clauses.size(); ci++) {
+        if (instance->clauses[ci].literals.size() > 2) {
+            candidates.push_back(ci);
+        }
+    }
+    stable_sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        return instance->clauses[a].literals.size() > instance->clauses[b].literals.size();
+    });
+    vivify(candidates, vivifyBudget);
+}
+
+// Probes the tier 1 and tier 2 learned clauses that were not probed yet, lowest LBD first since
+// those are kept longest
+void Solver::vivifyLearnts() {
+    uint64_t budget = min(vivifyBudget, (stats.propagations - lastVivify) / VIVIFY_SHARE);
+    vector<size_t> candidates;
+    for (size_t ci = 0; ci < instance->clauses.size(); ci++) {
+        const Clause &clause = instance->clauses[ci];
+        if (clause.learnt && !clause.vivified && clause.lbd <= TIER2_LBD &&
+            clause.literals.size() > 2) {
+            candidates.push_back(ci);
+        }
+    }
+    stable_sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        return instance->clauses[a].lbd < instance->clauses[b].lbd;
+    });
+    vivify(candidates, budget);
 } /*}}}*/
 
 /*{{{ Solve Main*/
-bool Solver::solve() {
+// Builds the search state for the first solve: per-variable arrays, at-most-one constraints,
+// watchers and the root units, then vivifies. Returns false if the root is already conflicting.
+bool Solver::init() {
+    // Trust the literals over the problem line in case it undercounts
+    int numVars = instance->getNumVars();
+    for (const Clause &clause : instance->clauses) {
+        for (int lit : clause.literals) {
+            numVars = max(numVars, abs(lit));
+        }
+    }
+    size_t n = static_cast<size_t>(numVars) + 1;
+    level.assign(n, 0);
+    reason.assign(n, NO_REASON);
+    seen.assign(n, false);
+    trail.clear();
+    trailLim.clear();
+    numLearnts = 0;
+    initAmo(numVars);
+    maxLearnts = instance->clauses.size() / 3 + 1000;
+
+    initOrder(numVars);
     instance->initWatchers();
-    return dpll();
+    bool sat = assignUnits();
+    if (sat && vivifyBudget > 0) {
+        vivifyProblem();
+        sat = assignUnits();
+    }
+    stats.avgClauseLength = instance->averageClauseLength();
+    countClauseBytes();
+    initialized = true;
+    return sat;
+}
+
+// Extends the per-variable state to variables first seen in a clause or assumption given
+// between incremental solves
+void Solver::growVars(int numVars) {
+    size_t n = static_cast<size_t>(numVars) + 1;
+    size_t old = level.size();
+    if (n <= old) {
+        return;
+    }
+    level.resize(n, 0);
+    reason.resize(n, NO_REASON);
+    seen.resize(n, false);
+    savedPhase.resize(n, 1);
+    trigger.resize(n, 0);
+    amosOf.resize(2 * n);
+    order.grow(numVars);
+    for (size_t var = old; var < n; var++) {
+        order.insert(static_cast<int>(var));
+    }
+}
+
+// Simplifies a clause given between solves against the root assignment and watches it right
+// away; a unit is assigned at the root. Returns false if it is satisfied at the root or a
+// tautology, and so was not added.
+bool Solver::attachAtRoot(const vector<int> &literals, bool learnt) {
+    backtrack(0);
+    int maxVar = 0;
+    for (int lit : literals) {
+        maxVar = max(maxVar, abs(lit));
+    }
+    growVars(maxVar);
+
+    vector<int> kept;
+    for (int lit : literals) {
+        if (instance->isTrue(lit) || find(kept.begin(), kept.end(), -lit) != kept.end()) {
+            return false; // Satisfied at the root, or a tautology
+        }
+        if (!instance->isFalse(lit) && find(kept.begin(), kept.end(), lit) == kept.end()) {
+            kept.push_back(lit);
+        }
+    }
+    if (kept.empty()) {
+        ok = false;
+        return false;
+    }
+    for (int lit : kept) {
+        order.insert(abs(lit)); // It may have been in no clause so far
+    }
+    // The levels an imported clause was learned at are unknown; its size bounds its LBD
+    size_t ci = addClause(kept, learnt, learnt ? static_cast<int>(kept.size()) : 0);
+    if (kept.size() == 1) {
+        assign(kept[0], 0, ci);
+    }
+    return true;
+}
+
+// Before the first solve the clause is only stored. Afterwards it is attached at the root. The
+// pure literal counts do not cover the new clause, so they are dropped until solve() rebuilds
+// them.
+void Solver::addInputClause(const vector<int> &literals) {
+    if (!initialized) {
+        instance->addClause(literals);
+        return;
+    }
+    backtrack(0);
+    occurrences.clear();
+    attachAtRoot(literals, false);
+}
+
+// Imported clauses are implied by the formula, so they are learned clauses that reduceDB ages
+// out like the solver's own. Before the first solve there is no search to speed up, so they are
+// dropped.
+void Solver::importLearnt(const vector<int> &literals) {
+    if (initialized && attachAtRoot(literals, true)) {
+        numLearnts++;
+    }
+}
+
+SolveResult Solver::solve(const vector<int> &assumptions) {
+    Timer watch;
+    watch.start();
+    TRACE_EVENT(SolveBegin, 0, assumptions.size(), 0);
+
+    if (!initialized) {
+        ok = init();
+    } else {
+        backtrack(0);
+    }
+    this->assumptions = assumptions;
+    int maxVar = 0;
+    for (int lit : assumptions) {
+        maxVar = max(maxVar, abs(lit));
+    }
+    growVars(maxVar);
+    if (ok && pureLiterals) {
+        occurrences.init(instance->clauses, amos, static_cast<int>(level.size()) - 1,
+                         instance->assignment);
+    }
+
+    SolveResult result = ok ? SolveResult::SAT : SolveResult::UNSAT;
+    if (ok && memLimit > 0 && memoryUsage() > memLimit) {
+        result = SolveResult::UNKNOWN; // The problem alone does not fit
+    } else if (ok) {
+        result = dpll();
+    }
+    memoryUsage();
+    watch.stop();
+    stats.searchTime += watch.getTime();
+    TRACE_EVENT(SolveEnd, decisionLevel(), result, 0);
+    return result;
 } /*}}}*/
+
+vector<vector<int>> Solver::takeExported() { return std::move(exported); }
+
+int Solver::branchLiteral() const {
+    size_t first = assumptions.size(); // Level first + 1 is the first one decided freely
+    if (trailLim.size() <= first || trailLim[first] >= trail.size()) {
+        return 0;
+    }
+    return trail[trailLim[first]];
+}
@@ -0,0 +1,48 @@
+#include "enumerate.h"
+
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+vector<int> parseVarList(const string &list) {
+    vector<int> vars;
+    istringstream items(list);
+    string item;
+    while (getline(items, item, ',')) {
+        size_t dash = item.find('-');
+        int first = stoi(item.substr(0, dash));
+        int last = dash == string::npos ? first : stoi(item.substr(dash + 1));
+        if (first < 1 || last < first) {
+            throw invalid_argument("Error: bad variable range: " + item);
+        }
+        for (int var = first; var <= last; var++) {
+            vars.push_back(var);
+        }
+    }
+    return vars;
+}
+
+bool enumerateModels(Solver &solver, const vector<int> &projection, uint64_t maxModels,
+                     const function<void(const vector<int> &)> &onModel) {
+    uint64_t found = 0;
+    while (true) {
+        SolveResult result = solver.solve();
+        if (result != SolveResult::SAT) {
+            return result == SolveResult::UNSAT;
+        }
+        Assignment model = solver.getAssignment();
+        vector<int> literals;
+        vector<int> blocking;
+        for (int var : projection) {
+            int lit = model[var] == 1 ? var : -var; // Unassigned counts as false, as when printed
+            literals.push_back(lit);
+            blocking.push_back(-lit);
+        }
+        onModel(literals);
+        if (maxModels > 0 && ++found >= maxModels) {
+            return false;
+        }
+        solver.addInputClause(blocking);
+    }
+}
@@ -0,0 +1,36 @@
+#include "fingerprint.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+static uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+Fingerprint::Fingerprint() : high(0), low(0) {}
+
+void Fingerprint::add(const vector<int> &clause) {
+    vector<int> sorted = clause;
+    sort(sorted.begin(), sorted.end());
+    // Two independently seeded chains over the literals, so the halves do not collide together
+    uint64_t a = 0x9e3779b97f4a7c15ULL ^ sorted.size();
+    uint64_t b = 0xc2b2ae3d27d4eb4fULL ^ sorted.size();
+    for (int lit : sorted) {
+        uint64_t x = static_cast<uint64_t>(static_cast<int64_t>(lit));
+        a = mix(a ^ x) + 0x165667b19e3779f9ULL;
+        b = mix(b + x) ^ 0x27d4eb2f165667c5ULL;
+    }
+    high += mix(a);
+    low += mix(b);
+}
+
+string Fingerprint::hex() const {
+    char buf[33];
+    snprintf(buf, sizeof(buf), "%016llx%016llx", static_cast<unsigned long long>(high),
+             static_cast<unsigned long long>(low));
+    return buf;
+}
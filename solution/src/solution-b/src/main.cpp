@@ -1,8 +1,21 @@
+#include "backbone.h"
+#include "binary_cnf.h"
+#include "cancel.h"
 #include "dimacs_parser.h"
+#include "distributed.h"
 #include "dpll.h"
+#include "enumerate.h"
+#include "renumber.h"
+#include "report.h"
+#include "result_cache.h"
 #include "sat_instance.h"
+#include "server.h"
+#include "sls.h"
+#include "symmetry.h"
 #include "timer.h"
+#include "trace.h"
 
+#include <csignal>
 #include <filesystem>
 #include <iostream>
 #include <string>
@@ -10,43 +23,341 @@
 using namespace std;
 namespace fs = filesystem;
 
+void printUsage() {
+    cout << "Usage: ./main [options] <cnf file>" << endl;
+    cout << "       ./main [options] --serve <socket>" << endl;
+    cout << "       ./main --convert <out file> <cnf file>" << endl;
+    cout << "Options:" << endl;
+    cout << "  --reorder         Renumber variables and clauses for locality before solving" << endl;
+    cout << "  --sls             Solve with local search only (UNKNOWN if no model is found)" << endl;
+    cout << "  --sls-init        Run local search first and seed the solver's phases with it" << endl;
+    cout << "  --sls-flips <n>   Flip budget for local search (default 1000000)" << endl;
+    cout << "  --chrono <n>      Backtrack one level instead of backjumping more than n levels" << endl;
+    cout << "  --pure            Branch on pure literals before the VSIDS order" << endl;
+    cout << "  --symmetry <s>    Spend up to s seconds finding symmetries to break (default 0, off)" << endl;
+    cout << "  --no-amo          Keep pairwise at-most-one clauses instead of native constraints" << endl;
+    cout << "  --vivify-budget <n>  Propagations per vivification pass, on the problem clauses and at restarts (default 0, off)" << endl;
+    cout << "  --mem-limit <MB>  Memory budget for the search, UNKNOWN if it cannot fit (default none)" << endl;
+    cout << "  --time-limit <s>  Stop with UNKNOWN and the stats so far after s seconds (default none)" << endl;
+    cout << "  --backbone        Report the literals that hold in every model instead of one model" << endl;
+    cout << "  --enumerate       List every model, one JSON line each, instead of solving once" << endl;
+    cout << "  --project <vars>  Variables the enumerated models are projected onto, e.g. 1-20,35" << endl;
+    cout << "  --max-models <n>  Stop the enumeration after n models (default no limit)" << endl;
+    cout << "  --result-cache <dir>  Reuse verdicts of earlier runs on the same clauses, stored in dir" << endl;
+    cout << "  --results-log <file>  Also take checked models from this log of earlier runs" << endl;
+    cout << "  --convert <file>  Write the formula as binary CNF, which loads faster, instead of solving" << endl;
+    cout << "  --trace <file>    Record search events in file for bin/trace_reader (build with make TRACE=1)" << endl;
+    cout << "  --coordinate <addr>  Split the formula into cubes for workers connecting to addr (host:port or a socket path)" << endl;
+    cout << "  --worker <addr>   Solve cubes for the coordinator at addr until it is done; takes no file" << endl;
+    cout << "  --cube-vars <k>   First cubes of the coordinator fix the k most frequent variables (default 3)" << endl;
+    cout << "  --split-after <s> Split a cube running s seconds when a worker is idle (default 0.5)" << endl;
+    cout << "  --share <n>       Learned clauses a worker shares with the others, up to n literals (default 8)" << endl;
+    cout << "  --serve <socket>  Answer requests on a Unix socket; --time-limit applies per request" << endl;
+    cout << "  --workers <n>     Requests solved concurrently by the server (default 4)" << endl;
+    cout << "  --cache <n>       Base formulas the server keeps loaded (default 16)" << endl;
+}
+
+// SIGINT/SIGTERM ask the search to stop and report what it has; a second signal kills the process
+void onSignal(int sig) {
+    Cancel::stop();
+    signal(sig, SIG_DFL);
+}
+
+// "3 true 7 false" for the literals 3 and -7, the format of the Solution field
+static string literalList(const vector<int> &literals) {
+    string list;
+    for (int lit : literals) {
+        list += to_string(abs(lit)) + (lit > 0 ? " true " : " false ");
+    }
+    if (!list.empty()) {
+        list.pop_back();
+    }
+    return list;
+}
+
+// Trusts the literals over the problem line in case it undercounts
+static int countVars(const SATInstance &instance) {
+    int numVars = instance.getNumVars();
+    for (const Clause &clause : instance.clauses) {
+        for (int lit : clause.literals) {
+            numVars = max(numVars, abs(lit));
+        }
+    }
+    return numVars;
+}
+
+// Parses the input, reporting a parse error the way the other input errors are reported
+static bool readInstance(const string &input, SATInstance &instance) {
+    try {
+        instance = parseCNFFile(input);
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return false;
+    }
+    return true;
+}
+
 int main(int argc, char *argv[]) {
-    if (argc < 2) {
-        cout << "Usage: ./main <cnf file>" << endl;
+    string input;
+    bool slsOnly = false;
+    bool slsInit = false;
+    bool pureLiterals = false;
+    bool reorder = false;
+    bool detectAmo = true;
+    uint64_t slsFlips = 1000000;
+    uint64_t vivifyBudget = 0;
+    int chronoThreshold = -1;
+    size_t memLimit = 0;
+    double timeLimit = 0.0;
+    double symmetryBudget = 0.0;
+    string resultCacheDir;
+    string resultsLog;
+    string convertTo;
+    bool backbone = false;
+    bool enumerate = false;
+    string projectList;
+    uint64_t maxModels = 0;
+    string traceFile;
+    ServerOptions server;
+    DistributedOptions distributed;
+    bool worker = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--sls") {
+            slsOnly = true;
+        } else if (arg == "--sls-init") {
+            slsInit = true;
+        } else if (arg == "--reorder") {
+            reorder = true;
+        } else if (arg == "--no-amo") {
+            detectAmo = false;
+        } else if (arg == "--backbone") {
+            backbone = true;
+        } else if (arg == "--enumerate") {
+            enumerate = true;
+        } else if (arg == "--project" && i + 1 < argc) {
+            projectList = argv[++i];
+        } else if (arg == "--max-models" && i + 1 < argc) {
+            maxModels = stoull(argv[++i]);
+        } else if (arg == "--pure") {
+            pureLiterals = true;
+        } else if (arg == "--sls-flips" && i + 1 < argc) {
+            slsFlips = stoull(argv[++i]);
+        } else if (arg == "--chrono" && i + 1 < argc) {
+            chronoThreshold = stoi(argv[++i]);
+        } else if (arg == "--vivify-budget" && i + 1 < argc) {
+            vivifyBudget = stoull(argv[++i]);
+        } else if (arg == "--mem-limit" && i + 1 < argc) {
+            memLimit = stoull(argv[++i]) * 1024 * 1024;
+        } else if (arg == "--time-limit" && i + 1 < argc) {
+            timeLimit = stod(argv[++i]);
+        } else if (arg == "--symmetry" && i + 1 < argc) {
+            symmetryBudget = stod(argv[++i]);
+        } else if (arg == "--result-cache" && i + 1 < argc) {
+            resultCacheDir = argv[++i];
+        } else if (arg == "--results-log" && i + 1 < argc) {
+            resultsLog = argv[++i];
+        } else if (arg == "--convert" && i + 1 < argc) {
+            convertTo = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (arg == "--coordinate" && i + 1 < argc) {
+            distributed.address = argv[++i];
+        } else if (arg == "--worker" && i + 1 < argc) {
+            distributed.address = argv[++i];
+            worker = true;
+        } else if (arg == "--cube-vars" && i + 1 < argc) {
+            distributed.cubeVars = stoull(argv[++i]);
+        } else if (arg == "--split-after" && i + 1 < argc) {
+            distributed.splitAfter = stod(argv[++i]);
+        } else if (arg == "--share" && i + 1 < argc) {
+            distributed.shareLimit = stoull(argv[++i]);
+        } else if (arg == "--serve" && i + 1 < argc) {
+            server.socketPath = argv[++i];
+        } else if (arg == "--workers" && i + 1 < argc) {
+            server.workers = stoull(argv[++i]);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            server.cacheSize = stoull(argv[++i]);
+        } else if (arg.rfind("--", 0) == 0 || !input.empty()) {
+            printUsage();
+            return 1;
+        } else {
+            input = arg;
+        }
+    }
+    if (!traceFile.empty() && !Trace::open(traceFile)) {
+        cerr << "Error: cannot trace to " << traceFile
+             << (TRACE_COMPILED ? "" : ": built without tracing, rebuild with make TRACE=1") << endl;
+        return 1;
+    }
+    if (!server.socketPath.empty() && input.empty()) {
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
+        server.timeLimit = timeLimit;
+        server.vivifyBudget = vivifyBudget;
+        server.chronoThreshold = chronoThreshold;
+        server.memLimit = memLimit;
+        server.pureLiterals = pureLiterals;
+        server.detectAmo = detectAmo;
+        return Server(server).run();
+    }
+    if (worker && input.empty() && server.socketPath.empty()) {
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
+        distributed.vivifyBudget = vivifyBudget;
+        distributed.chronoThreshold = chronoThreshold;
+        distributed.memLimit = memLimit;
+        distributed.pureLiterals = pureLiterals;
+        distributed.detectAmo = detectAmo;
+        return Worker(distributed).run();
+    }
+    if (input.empty() || !server.socketPath.empty() || worker) {
+        printUsage();
+        return 1;
+    }
+    if ((enumerate || backbone) && (reorder || symmetryBudget > 0.0 || slsOnly || slsInit)) {
+        // Symmetry breaking removes models, and the others rewrite or bypass the solver
+        cerr << "Error: --enumerate and --backbone cannot be combined with --reorder, --symmetry"
+             << " or --sls" << endl;
         return 1;
     }
 
-    string input = argv[1];
+    if (!convertTo.empty()) {
+        SATInstance instance(0, 0);
+        if (!readInstance(input, instance)) {
+            return 1;
+        }
+        uint64_t bytes = writeBinaryCNF(instance, convertTo);
+        cout << "{\"Converted\": \"" << jsonEscape(convertTo) << "\", \"Clauses\": "
+             << instance.clauses.size() << ", \"Bytes\": " << bytes << "}" << endl;
+        return 0;
+    }
+
     fs::path path(input);
     string filename = path.filename().string();
 
     Timer watch;
     watch.start();
+    if (timeLimit > 0.0) {
+        Cancel::setTimeLimit(watch, timeLimit);
+    }
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
 
-    SATInstance instance = parseCNFFile(input);
+    SATInstance instance(0, 0);
+    if (!readInstance(input, instance)) {
+        return 1;
+    }
+    ResultCache cache(resultCacheDir, resultsLog);
+    if (!resultCacheDir.empty() && !enumerate && !backbone) {
+        string cached;
+        Assignment model;
+        if (cache.lookup(instance, filename, cached, model)) {
+            watch.stop();
+            Stats stats;
+            stats.cacheHits = 1;
+            cout << resultJSON(filename, watch.getTime(), cached, model, stats) << endl;
+            return 0;
+        }
+    }
+    if (!distributed.address.empty()) {
+        // The workers take their solver options from their own command lines
+        Coordinator coordinator(instance, distributed);
+        SolveResult solved;
+        Assignment model;
+        Stats stats;
+        if (coordinator.run(solved, model, stats) != 0) {
+            return 1;
+        }
+        watch.stop();
+        cout << resultJSON(filename, watch.getTime(), resultName(solved), model, stats) << endl;
+        if (!resultCacheDir.empty()) {
+            cache.store(resultName(solved), model);
+        }
+        return 0;
+    }
+    Renumbering renumbering;
+    if (reorder) {
+        renumbering.apply(instance);
+    }
     Solver solver = Solver();
+    SymmetryBreaker symmetry;
+    if (symmetryBudget > 0.0) {
+        symmetry.apply(instance, symmetryBudget, solver.getStats());
+    }
     solver.setInstance(instance);
+    solver.setVivifyBudget(vivifyBudget);
+    solver.setChronoThreshold(chronoThreshold);
+    solver.setMemLimit(memLimit);
+    solver.setPureLiterals(pureLiterals);
+    solver.setDetectAmo(detectAmo);
     /* cout << instance.toString() << endl; */
-    bool sat = solver.solve();
-    watch.stop();
 
-    Assignment assignment = solver.getAssignment();
+    if (enumerate) {
+        vector<int> projection =
+            parseVarList(projectList.empty() ? "1-" + to_string(countVars(instance)) : projectList);
+        uint64_t numModels = 0;
+        // One line per model; endl flushes it so consumers see models as they are found
+        auto onModel = [&numModels](const vector<int> &model) {
+            cout << "{\"Model\": " << ++numModels << ", \"Solution\": \"" << literalList(model)
+                 << "\"}" << endl;
+        };
+        bool complete = enumerateModels(solver, projection, maxModels, onModel);
+        watch.stop();
+        cout << "{\"Instance\": \"" << jsonEscape(filename) << "\", \"Time\": " << fixed
+             << setprecision(2) << watch.getTime() << ", \"Models\": " << numModels
+             << ", \"Complete\": " << (complete ? "true" : "false")
+             << ", \"Stats\": " << solver.getStats().toJSON() << "}" << endl;
+        return 0;
+    }
 
-    if (sat) {
-        string solution;
-        for (const auto &[key, value] : assignment) {
-            solution += to_string(key) + " " + (value == 1 ? "true" : "false") + " ";
+    if (backbone) {
+        BackboneFinder finder(solver, countVars(instance));
+        SolveResult result;
+        vector<int> literals;
+        bool complete = finder.run(result, literals);
+        watch.stop();
+        cout << "{\"Instance\": \"" << jsonEscape(filename) << "\", \"Time\": " << fixed
+             << setprecision(2) << watch.getTime() << ", \"Result\": \"" << resultName(result)
+             << "\"";
+        if (result == SolveResult::SAT) {
+            cout << ", \"Backbone\": \"" << literalList(literals) << "\", \"BackboneSize\": "
+                 << literals.size() << ", \"Checks\": " << finder.checks << ", \"Complete\": "
+                 << (complete ? "true" : "false");
         }
-        if (!solution.empty()) {
-            solution.pop_back(); // Remove the trailing space
+        cout << ", \"Stats\": " << solver.getStats().toJSON() << "}" << endl;
+        return 0;
+    }
+
+    string result;
+    if (slsOnly || slsInit) {
+        LocalSearch sls(instance);
+        if (sls.run(slsFlips, solver.getStats())) {
+            instance.assignment = sls.getAssignment();
+            result = "SAT";
+        } else if (slsOnly) {
+            result = "UNKNOWN";
+        } else {
+            solver.setPhases(sls.getPhases());
         }
+    }
+    if (result.empty()) {
+        result = resultName(solver.solve());
+    }
+    watch.stop();
 
-        cout << "{\"Instance\": \"" << filename << "\", \"Time\": " << fixed << setprecision(2)
-             << watch.getTime() << ", \"Result\": \"SAT\", \"Solution\": \"" << solution << "\"}"
-             << endl;
-    } else {
-        cout << "{\"Instance\": \"" << filename << "\", \"Time\": " << fixed << setprecision(2)
-             << watch.getTime() << ", \"Result\": \"UNSAT\"}" << endl;
+    Assignment assignment;
+    if (result == "SAT") {
+        assignment = solver.getAssignment();
+        symmetry.strip(assignment);
+        if (reorder) {
+            assignment = renumbering.restore(assignment);
+        }
+    }
+    cout << resultJSON(filename, watch.getTime(), result, assignment, solver.getStats()) << endl;
+    if (!resultCacheDir.empty()) {
+        cache.store(result, assignment);
     }
 
     return 0;
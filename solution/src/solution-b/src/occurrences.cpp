@@ -0,0 +1,120 @@
+#include "occurrences.h"
+
+#include <cstdlib>
+
+using namespace std;
+
+size_t Occurrences::litIndex(int lit) {
+    return 2 * static_cast<size_t>(abs(lit)) + (lit < 0 ? 1u : 0u);
+}
+
+void Occurrences::init(const vector<Clause> &clauses, const vector<vector<int>> &amos, int numVars,
+                       Assignment &assignment) {
+    size_t numClauses = clauses.size();
+    size_t numLits = 2 * static_cast<size_t>(numVars) + 2;
+    lits.clear();
+    clauseStart.assign(1, 0);
+    occurStart.assign(numLits + 1, 0);
+    for (size_t c = 0; c < numClauses; c++) {
+        if (!clauses[c].learnt) { // A learned clause keeps an empty span
+            for (int lit : clauses[c].literals) {
+                lits.push_back(lit);
+                occurStart[litIndex(lit) + 1]++;
+            }
+        }
+        clauseStart.push_back(lits.size());
+    }
+    for (size_t i = 0; i < numLits; i++) {
+        occurStart[i + 1] += occurStart[i];
+    }
+
+    occurs.assign(lits.size(), 0);
+    vector<size_t> fill(occurStart.begin(), occurStart.end() - 1);
+    numTrue.assign(numClauses, 0);
+    count.assign(numLits, 0);
+    for (size_t c = 0; c < numClauses; c++) {
+        for (size_t i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            occurs[fill[litIndex(lits[i])]++] = c;
+            int value = assignment[abs(lits[i])];
+            if (value != 0 && (value > 0) == (lits[i] > 0)) {
+                numTrue[c]++;
+            }
+        }
+        if (numTrue[c] == 0) {
+            for (size_t i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+                count[litIndex(lits[i])]++;
+            }
+        }
+    }
+
+    for (const auto &amo : amos) {
+        for (int lit : amo) {
+            count[litIndex(-lit)]++;
+        }
+    }
+
+    candidates.clear();
+    for (int var = numVars; var >= 1; var--) {
+        candidates.push_back(var);
+    }
+}
+
+bool Occurrences::enabled() const { return !count.empty(); }
+
+void Occurrences::clear() {
+    lits.clear();
+    clauseStart.clear();
+    occurs.clear();
+    occurStart.clear();
+    numTrue.clear();
+    count.clear();
+    candidates.clear();
+}
+
+void Occurrences::onAssign(int lit) {
+    size_t l = litIndex(lit);
+    for (size_t k = occurStart[l]; k < occurStart[l + 1]; k++) {
+        size_t c = occurs[k];
+        if (numTrue[c]++ > 0) {
+            continue;
+        }
+        // The clause just became satisfied; it no longer counts for any of its literals
+        for (size_t i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            if (--count[litIndex(lits[i])] == 0) {
+                candidates.push_back(abs(lits[i]));
+            }
+        }
+    }
+}
+
+void Occurrences::onUnassign(int lit) {
+    size_t l = litIndex(lit);
+    for (size_t k = occurStart[l]; k < occurStart[l + 1]; k++) {
+        size_t c = occurs[k];
+        if (--numTrue[c] > 0) {
+            continue;
+        }
+        for (size_t i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            count[litIndex(lits[i])]++;
+        }
+    }
+    candidates.push_back(abs(lit)); // It may still be pure at the level backtracked to
+}
+
+int Occurrences::nextPure(Assignment &assignment) {
+    while (!candidates.empty()) {
+        int var = candidates.back();
+        candidates.pop_back();
+        if (assignment[var] != 0) {
+            continue;
+        }
+        int pos = count[litIndex(var)], neg = count[litIndex(-var)];
+        if (pos > 0 && neg == 0) {
+            return var;
+        }
+        if (neg > 0 && pos == 0) {
+            return -var;
+        }
+    }
+    return 0;
+}
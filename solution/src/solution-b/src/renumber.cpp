@@ -0,0 +1,103 @@
+#include "renumber.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+
+using namespace std;
+
+void Renumbering::apply(SATInstance &instance) {
+    vector<Clause> &clauses = instance.clauses;
+    int numVars = instance.getNumVars();
+    for (const Clause &clause : clauses) {
+        for (int lit : clause.literals) {
+            numVars = max(numVars, abs(lit));
+        }
+    }
+    size_t n = static_cast<size_t>(numVars) + 1;
+
+    // Clauses of each variable; the number of occurrences stands in for the graph degree
+    vector<vector<size_t>> occurs(n);
+    for (size_t ci = 0; ci < clauses.size(); ci++) {
+        for (int lit : clauses[ci].literals) {
+            occurs[static_cast<size_t>(abs(lit))].push_back(ci);
+        }
+    }
+    auto byDegree = [&occurs](int a, int b) {
+        size_t da = occurs[static_cast<size_t>(a)].size();
+        size_t db = occurs[static_cast<size_t>(b)].size();
+        return da != db ? da < db : a < b;
+    };
+
+    // Cuthill-McKee: breadth-first from a lowest-degree variable of each component, visiting
+    // the new neighbors of every variable in increasing degree. Each clause is expanded once.
+    vector<int> starts;
+    for (int var = 1; var <= numVars; var++) {
+        starts.push_back(var);
+    }
+    sort(starts.begin(), starts.end(), byDegree);
+
+    vector<bool> visited(n, false), expanded(clauses.size(), false);
+    vector<int> order;
+    for (int start : starts) {
+        if (visited[static_cast<size_t>(start)]) {
+            continue;
+        }
+        visited[static_cast<size_t>(start)] = true;
+        size_t head = order.size();
+        order.push_back(start);
+        while (head < order.size()) {
+            int var = order[head++];
+            size_t batch = order.size();
+            for (size_t ci : occurs[static_cast<size_t>(var)]) {
+                if (expanded[ci]) {
+                    continue;
+                }
+                expanded[ci] = true;
+                for (int lit : clauses[ci].literals) {
+                    if (!visited[static_cast<size_t>(abs(lit))]) {
+                        visited[static_cast<size_t>(abs(lit))] = true;
+                        order.push_back(abs(lit));
+                    }
+                }
+            }
+            sort(order.begin() + static_cast<ptrdiff_t>(batch), order.end(), byDegree);
+        }
+    }
+    reverse(order.begin(), order.end());
+
+    toOriginal.assign(n, 0);
+    vector<int> toNew(n, 0);
+    for (size_t i = 0; i < order.size(); i++) {
+        toNew[static_cast<size_t>(order[i])] = static_cast<int>(i) + 1;
+        toOriginal[i + 1] = order[i];
+    }
+
+    // Rewrite the clauses, then store them in order of their lowest variable
+    vector<pair<int, size_t>> firstVar;
+    for (size_t ci = 0; ci < clauses.size(); ci++) {
+        vector<int> literals;
+        for (int lit : clauses[ci].literals) {
+            int var = toNew[static_cast<size_t>(abs(lit))];
+            literals.push_back(lit > 0 ? var : -var);
+        }
+        sort(literals.begin(), literals.end(), [](int a, int b) { return abs(a) < abs(b); });
+        firstVar.push_back({literals.empty() ? 0 : abs(literals[0]), ci});
+        clauses[ci] = Clause(literals);
+    }
+    stable_sort(firstVar.begin(), firstVar.end());
+    vector<Clause> sorted;
+    sorted.reserve(clauses.size());
+    for (const auto &[var, ci] : firstVar) {
+        sorted.push_back(move(clauses[ci]));
+    }
+    clauses = move(sorted);
+}
+
+Assignment Renumbering::restore(const Assignment &assignment) const {
+    Assignment original;
+    for (const auto &[var, value] : assignment) {
+        original[toOriginal[static_cast<size_t>(var)]] = value;
+    }
+    return original;
+}
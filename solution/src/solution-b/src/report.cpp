@@ -0,0 +1,69 @@
+#include "report.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+string resultName(SolveResult result) {
+    switch (result) {
+    case SolveResult::SAT:
+        return "SAT";
+    case SolveResult::UNSAT:
+        return "UNSAT";
+    case SolveResult::UNKNOWN:
+        break;
+    }
+    return "UNKNOWN";
+}
+
+string jsonEscape(const string &text) {
+    ostringstream buf;
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            buf << "\\\"";
+            break;
+        case '\\':
+            buf << "\\\\";
+            break;
+        case '\n':
+            buf << "\\n";
+            break;
+        case '\r':
+            buf << "\\r";
+            break;
+        case '\t':
+            buf << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                buf << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c) << dec;
+            } else {
+                buf << c;
+            }
+        }
+    }
+    return buf.str();
+}
+
+string resultJSON(const string &instance, double seconds, const string &result,
+                  const Assignment &model, const Stats &stats) {
+    ostringstream buf;
+    buf << "{\"Instance\": \"" << jsonEscape(instance) << "\", \"Time\": " << fixed
+        << setprecision(2) << seconds << ", \"Result\": \"" << result << "\"";
+
+    if (result == "SAT") {
+        string solution;
+        for (const auto &[key, value] : model) {
+            solution += to_string(key) + " " + (value == 1 ? "true" : "false") + " ";
+        }
+        if (!solution.empty()) {
+            solution.pop_back(); // Remove the trailing space
+        }
+        buf << ", \"Solution\": \"" << solution << "\"";
+    }
+
+    buf << ", \"Stats\": " << stats.toJSON() << "}";
+    return buf.str();
+}
@@ -0,0 +1,123 @@
+#include "result_cache.h"
+#include "report.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace std;
+namespace fs = filesystem;
+
+ResultCache::ResultCache(const string &directory, const string &resultsLog)
+    : directory(directory), resultsLog(resultsLog), numClauses(0) {}
+
+bool ResultCache::satisfies(const SATInstance &instance, const Assignment &model) {
+    for (const Clause &clause : instance.clauses) {
+        bool sat = false;
+        for (int lit : clause.literals) {
+            auto it = model.find(abs(lit));
+            if (it != model.end() && (it->second == 1) == (lit > 0)) {
+                sat = true;
+                break;
+            }
+        }
+        if (!sat) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The last "Solution" logged for the instance, if it satisfies the formula
+bool ResultCache::fromLog(const SATInstance &instance, const string &name,
+                          Assignment &model) const {
+    ifstream log(resultsLog);
+    const string instanceKey = "\"Instance\": \"" + jsonEscape(name) + "\"";
+    const string solutionKey = "\"Solution\": \"";
+    string line;
+    bool found = false;
+    while (getline(log, line)) {
+        size_t start = line.find(solutionKey);
+        if (line.find(instanceKey) == string::npos || start == string::npos) {
+            continue;
+        }
+        start += solutionKey.size();
+        istringstream solution(line.substr(start, line.find('"', start) - start));
+        Assignment candidate;
+        int var;
+        string value;
+        while (solution >> var >> value) {
+            candidate[var] = value == "true" ? 1 : -1;
+        }
+        if (satisfies(instance, candidate)) {
+            model = candidate;
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool ResultCache::lookup(const SATInstance &instance, const string &name, string &result,
+                         Assignment &model) {
+    entry = (fs::path(directory) / instance.fingerprint.hex()).string();
+    numClauses = instance.clauses.size();
+
+    // Entry format: "c <clauses>", "s SATISFIABLE" or "s UNSATISFIABLE", then "v" model lines
+    ifstream file(entry);
+    string tag, verdict;
+    size_t storedClauses = 0;
+    if (file >> tag >> storedClauses >> tag >> verdict && storedClauses == numClauses) {
+        if (verdict == "UNSATISFIABLE") {
+            result = "UNSAT";
+            return true;
+        }
+        Assignment stored;
+        int lit;
+        while (file >> tag) {
+            while (file >> lit && lit != 0) {
+                stored[abs(lit)] = lit > 0 ? 1 : -1;
+            }
+        }
+        if (verdict == "SATISFIABLE" && satisfies(instance, stored)) {
+            model = stored;
+            result = "SAT";
+            return true;
+        }
+    }
+
+    if (!resultsLog.empty() && fromLog(instance, name, model)) {
+        result = "SAT";
+        store(result, model);
+        return true;
+    }
+    return false;
+}
+
+// Written to a temporary file and renamed, so concurrent runs never read a partial entry
+void ResultCache::store(const string &result, const Assignment &model) const {
+    if (entry.empty() || (result != "SAT" && result != "UNSAT")) {
+        return;
+    }
+    error_code ignored;
+    fs::create_directories(directory, ignored);
+    string temp = entry + ".tmp" + to_string(getpid());
+    {
+        ofstream file(temp);
+        file << "c " << numClauses << "\n";
+        file << "s " << (result == "SAT" ? "SATISFIABLE" : "UNSATISFIABLE") << "\n";
+        if (result == "SAT") {
+            file << "v";
+            for (const auto &[var, value] : model) {
+                file << " " << (value == 1 ? var : -var);
+            }
+            file << " 0\n";
+        }
+        if (!file) {
+            fs::remove(temp, ignored);
+            return;
+        }
+    }
+    fs::rename(temp, entry, ignored);
+}
@@ -38,8 +38,18 @@ bool SATInstance::isFalse(int lit) {
 }
 
 // Getters
-int SATInstance::getNumVars() { return numVars; }
-int SATInstance::getNumClauses() { return numClauses; }
+int SATInstance::getNumVars() const { return numVars; }
+int SATInstance::getNumClauses() const { return numClauses; }
+
+double SATInstance::averageClauseLength() const {
+    if (clauses.empty())
+        return 0.0;
+    size_t total = 0;
+    for (const Clause &clause : clauses) {
+        total += clause.literals.size();
+    }
+    return static_cast<double>(total) / static_cast<double>(clauses.size());
+}
 
 // Converts the SATInstance object to a string representation
 string SATInstance::toString() const {
@@ -0,0 +1,312 @@
+#include "server.h"
+#include "cancel.h"
+#include "dimacs_parser.h"
+#include "report.h"
+#include "socket_io.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+// How often a blocked accept looks at the stop flag
+static const int POLL_MS = 200;
+
+static string errorJSON(const string &message) {
+    return "{\"Error\": \"" + jsonEscape(message) + "\"}";
+}
+
+/*{{{ Base Cache */
+Server::Base::Base(SATInstance formula)
+    : parsed(std::move(formula)), instance(parsed), numVars(parsed.getNumVars()),
+      retiredClauses(0) {
+    for (const Clause &clause : parsed.clauses) {
+        for (int lit : clause.literals) {
+            numVars = max(numVars, abs(lit));
+        }
+    }
+    nextSelector = numVars + 1;
+}
+
+Server::Server(const ServerOptions &options) : options(options), stopping(false) {}
+
+void Server::configure(Solver &solver) const {
+    solver.setVivifyBudget(options.vivifyBudget);
+    solver.setChronoThreshold(options.chronoThreshold);
+    solver.setMemLimit(options.memLimit);
+    solver.setPureLiterals(options.pureLiterals);
+    solver.setDetectAmo(options.detectAmo);
+}
+
+shared_ptr<Server::Base> Server::lookup(const string &id) {
+    lock_guard<mutex> guard(cacheLock);
+    auto it = cached.find(id);
+    if (it == cached.end()) {
+        return nullptr;
+    }
+    lru.splice(lru.begin(), lru, it->second);
+    return it->second->second;
+}
+
+// A base that is evicted while a request uses it lives on until that request is done
+void Server::store(const string &id, shared_ptr<Base> base) {
+    lock_guard<mutex> guard(cacheLock);
+    auto it = cached.find(id);
+    if (it != cached.end()) {
+        lru.erase(it->second);
+    }
+    lru.emplace_front(id, std::move(base));
+    cached[id] = lru.begin();
+    while (lru.size() > max<size_t>(options.cacheSize, 1)) {
+        cached.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+// Drops the learned clauses and retired request clauses and starts from the parsed formula
+void Server::reset(Base &base) const {
+    base.instance = base.parsed;
+    base.solver = Solver();
+    configure(base.solver);
+    base.solver.setInstance(base.instance);
+    base.nextSelector = base.numVars + 1;
+    base.retiredClauses = 0;
+} /*}}}*/
+
+/*{{{ Requests */
+static SATInstance parseBody(const vector<string> &body) {
+    string text;
+    for (const string &line : body) {
+        text += line + "\n";
+    }
+    istringstream input(text);
+    return parseCNF(input);
+}
+
+string Server::load(const string &id, const vector<string> &body) {
+    auto base = make_shared<Base>(parseBody(body));
+    configure(base->solver);
+    base->solver.setInstance(base->instance);
+    ostringstream response;
+    response << "{\"Loaded\": \"" << jsonEscape(id) << "\", \"Variables\": " << base->numVars
+             << ", \"Clauses\": " << base->parsed.clauses.size() << "}";
+    store(id, std::move(base));
+    return response.str();
+}
+
+string Server::solve(const vector<string> &body) {
+    Timer watch;
+    watch.start();
+    if (options.timeLimit > 0.0) {
+        Cancel::setTimeLimit(watch, options.timeLimit);
+    }
+    SATInstance instance = parseBody(body);
+    Solver solver;
+    configure(solver);
+    solver.setInstance(instance);
+    SolveResult result = solver.solve();
+    watch.stop();
+    return resultJSON("request", watch.getTime(), resultName(result), solver.getAssignment(),
+                      solver.getStats());
+}
+
+string Server::solveBase(const string &id, const vector<string> &body) {
+    shared_ptr<Base> base = lookup(id);
+    if (!base) {
+        return errorJSON("Unknown base formula: " + id);
+    }
+    lock_guard<mutex> guard(base->lock);
+
+    vector<vector<int>> clauses;
+    vector<int> assumptions;
+    for (const string &line : body) {
+        istringstream tokens(line);
+        string first;
+        if (!(tokens >> first) || first == "c") {
+            continue;
+        }
+        bool assumed = first == "a";
+        vector<int> literals;
+        if (!assumed) {
+            literals.push_back(stoi(first));
+        }
+        int lit;
+        while (tokens >> lit) {
+            literals.push_back(lit);
+        }
+        if (literals.empty() || literals.back() != 0) {
+            return errorJSON("Line does not end with 0: " + line);
+        }
+        literals.pop_back();
+        for (int l : literals) {
+            if (l == 0 || abs(l) > base->numVars) {
+                return errorJSON("Variable out of range: " + to_string(l));
+            }
+        }
+        if (assumed) {
+            assumptions.insert(assumptions.end(), literals.begin(), literals.end());
+        } else {
+            clauses.push_back(literals);
+        }
+    }
+
+    int selector = 0;
+    if (!clauses.empty()) {
+        selector = base->nextSelector++;
+        for (vector<int> &clause : clauses) {
+            clause.push_back(-selector);
+            base->solver.addInputClause(clause);
+        }
+        assumptions.insert(assumptions.begin(), selector);
+    }
+
+    Timer watch;
+    watch.start();
+    if (options.timeLimit > 0.0) {
+        Cancel::setTimeLimit(watch, options.timeLimit);
+    }
+    base->solver.getStats() = Stats();
+    SolveResult result = base->solver.solve(assumptions);
+    watch.stop();
+
+    Assignment model = base->solver.getAssignment();
+    erase_if(model, [&](const auto &entry) { return entry.first > base->numVars; });
+    string response = resultJSON(id, watch.getTime(), resultName(result), model,
+                                 base->solver.getStats());
+
+    if (selector != 0) {
+        base->solver.addInputClause({-selector});
+        base->retiredClauses += clauses.size();
+        if (base->retiredClauses > base->parsed.clauses.size()) {
+            reset(*base);
+        }
+    }
+    return response;
+}
+
+string Server::drop(const string &id) {
+    lock_guard<mutex> guard(cacheLock);
+    auto it = cached.find(id);
+    if (it == cached.end()) {
+        return errorJSON("Unknown base formula: " + id);
+    }
+    lru.erase(it->second);
+    cached.erase(it);
+    return "{\"Dropped\": \"" + jsonEscape(id) + "\"}";
+}
+
+string Server::handle(const string &command, const string &id, const vector<string> &body) {
+    try {
+        if (command == "load" && !id.empty()) {
+            return load(id, body);
+        }
+        if (command == "solve") {
+            return id.empty() ? solve(body) : solveBase(id, body);
+        }
+        if (command == "drop" && !id.empty()) {
+            return drop(id);
+        }
+        return errorJSON("Unknown request: " + command + " " + id);
+    } catch (const exception &e) {
+        return errorJSON(e.what());
+    }
+} /*}}}*/
+
+/*{{{ Connections */
+void Server::serve(int client) {
+    LineReader reader(client);
+    string line;
+    while (reader.next(line)) {
+        istringstream header(line);
+        string command, id;
+        header >> command >> id;
+        if (command.empty()) {
+            continue;
+        }
+        vector<string> body;
+        if (command == "load" || command == "solve") {
+            bool ended = false;
+            while (!ended && reader.next(line)) {
+                ended = line == "end";
+                if (!ended) {
+                    body.push_back(line);
+                }
+            }
+            if (!ended) {
+                return; // Closed in the middle of a request
+            }
+        }
+        if (!sendAll(client, handle(command, id, body) + "\n")) {
+            return;
+        }
+    }
+}
+
+void Server::work() {
+    while (true) {
+        int client;
+        {
+            unique_lock<mutex> guard(queueLock);
+            queueReady.wait(guard, [this] { return stopping || !pending.empty(); });
+            if (stopping) {
+                return;
+            }
+            client = pending.front();
+            pending.pop();
+        }
+        serve(client);
+        close(client);
+    }
+}
+
+int Server::run() {
+    int listener = listenOn(options.socketPath);
+    if (listener < 0) {
+        cerr << "Error: cannot listen on " << options.socketPath << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    vector<thread> workers;
+    for (size_t i = 0; i < max<size_t>(options.workers, 1); i++) {
+        workers.emplace_back(&Server::work, this);
+    }
+    while (!Cancel::requested()) {
+        pollfd ready = {listener, POLLIN, 0};
+        if (poll(&ready, 1, POLL_MS) <= 0) {
+            continue;
+        }
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        lock_guard<mutex> guard(queueLock);
+        pending.push(client);
+        queueReady.notify_one();
+    }
+
+    {
+        lock_guard<mutex> guard(queueLock);
+        stopping = true;
+        queueReady.notify_all();
+    }
+    for (thread &worker : workers) {
+        worker.join();
+    }
+    while (!pending.empty()) {
+        close(pending.front());
+        pending.pop();
+    }
+    close(listener);
+    removeAddress(options.socketPath);
+    return 0;
+} /*}}}*/
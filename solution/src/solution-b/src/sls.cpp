@@ -0,0 +1,269 @@
+#include "sls.h"
+#include "cancel.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+
+// Break counts above this share the same (negligible) ProbSAT weight
+static const size_t MAX_BREAK = 64;
+
+LocalSearch::LocalSearch(SATInstance &instance, uint32_t seed)
+    : numVars(instance.getNumVars()), hasEmptyClause(false), bestStale(false),
+      bestNumUnsat(SIZE_MAX), rng(seed) {
+    // Trust the literals over the problem line in case it undercounts
+    for (const Clause &clause : instance.clauses) {
+        for (int lit : clause.literals) {
+            numVars = max(numVars, abs(lit));
+        }
+    }
+    size_t n = static_cast<size_t>(numVars) + 1;
+
+    /*{{{ Flatten clauses, dropping duplicate literals and tautologies */
+    vector<int> seen(n, 0);
+    size_t maxLen = 0;
+    clauseStart.push_back(0);
+    for (const Clause &clause : instance.clauses) {
+        size_t start = lits.size();
+        bool tautology = false;
+        for (int lit : clause.literals) {
+            size_t var = static_cast<size_t>(abs(lit));
+            if (seen[var] == lit) {
+                continue;
+            }
+            if (seen[var] == -lit) {
+                tautology = true;
+                break;
+            }
+            seen[var] = lit;
+            lits.push_back(lit);
+        }
+        for (size_t i = start; i < lits.size(); i++) {
+            seen[static_cast<size_t>(abs(lits[i]))] = 0;
+        }
+
+        if (tautology) {
+            lits.resize(start);
+        } else if (lits.size() == start) {
+            hasEmptyClause = true;
+        } else {
+            maxLen = max(maxLen, lits.size() - start);
+            clauseStart.push_back(lits.size());
+        }
+    } /*}}}*/
+
+    /*{{{ Occurrence lists */
+    occurStart.assign(2 * n + 1, 0);
+    for (int lit : lits) {
+        occurStart[litIndex(lit) + 1]++;
+    }
+    partial_sum(occurStart.begin(), occurStart.end(), occurStart.begin());
+    occurs.resize(lits.size());
+    vector<size_t> fill(occurStart.begin(), occurStart.end() - 1);
+    for (size_t c = 0; c + 1 < clauseStart.size(); c++) {
+        for (size_t i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            occurs[fill[litIndex(lits[i])]++] = static_cast<uint32_t>(c);
+        }
+    } /*}}}*/
+
+    /*{{{ ProbSAT weights: polynomial for 3-SAT, exponential for longer clauses */
+    breakProb.resize(MAX_BREAK + 1);
+    for (size_t b = 0; b <= MAX_BREAK; b++) {
+        double breaks = static_cast<double>(b);
+        if (maxLen <= 3) {
+            breakProb[b] = pow(0.9 + breaks, -2.06);
+        } else {
+            double cb = maxLen == 4 ? 3.0 : maxLen == 5 ? 3.7 : maxLen == 6 ? 5.1 : 5.4;
+            breakProb[b] = pow(cb, -breaks);
+        }
+    }
+    weights.resize(maxLen); /*}}}*/
+}
+
+size_t LocalSearch::litIndex(int lit) const {
+    return 2 * static_cast<size_t>(abs(lit)) + (lit < 0 ? 1u : 0u);
+}
+
+/*{{{ Unsat list with O(1) removal */
+void LocalSearch::addUnsat(uint32_t c) {
+    unsatPos[c] = unsat.size();
+    unsat.push_back(c);
+}
+
+void LocalSearch::removeUnsat(uint32_t c) {
+    uint32_t last = unsat.back();
+    unsat[unsatPos[c]] = last;
+    unsatPos[last] = unsatPos[c];
+    unsat.pop_back();
+} /*}}}*/
+
+/*{{{ Random initial assignment and counters */
+void LocalSearch::initAssignment() {
+    size_t n = static_cast<size_t>(numVars) + 1;
+    size_t numClauses = clauseStart.size() - 1;
+
+    value.assign(n, 1);
+    for (size_t v = 1; v < n; v++) {
+        value[v] = (rng() & 1) ? 1 : -1;
+    }
+    numTrue.assign(numClauses, 0);
+    trueVarXor.assign(numClauses, 0);
+    breakCount.assign(n, 0);
+    makeCount.assign(n, 0);
+    unsat.clear();
+    unsatPos.assign(numClauses, 0);
+
+    for (size_t c = 0; c < numClauses; c++) {
+        for (size_t i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            int var = abs(lits[i]);
+            if (value[static_cast<size_t>(var)] == (lits[i] > 0 ? 1 : -1)) {
+                numTrue[c]++;
+                trueVarXor[c] ^= var;
+            }
+        }
+        if (numTrue[c] == 0) {
+            addUnsat(static_cast<uint32_t>(c));
+            for (size_t i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+                makeCount[static_cast<size_t>(abs(lits[i]))]++;
+            }
+        } else if (numTrue[c] == 1) {
+            breakCount[static_cast<size_t>(trueVarXor[c])]++;
+        }
+    }
+
+    sinceBest.clear();
+    bestStale = true;
+    bestNumUnsat = unsat.size();
+} /*}}}*/
+
+/*{{{ Pick a variable from an unsat clause with probability proportional to breakProb */
+int LocalSearch::pickVar(uint32_t c) {
+    const int *clause = lits.data() + clauseStart[c];
+    size_t len = clauseStart[c + 1] - clauseStart[c];
+
+    // Gather the weights in one branch-free pass over contiguous memory so the
+    // compiler can vectorize it, then do the (short) roulette selection.
+    for (size_t i = 0; i < len; i++) {
+        size_t breaks = static_cast<size_t>(breakCount[static_cast<size_t>(abs(clause[i]))]);
+        weights[i] = breakProb[min(breaks, MAX_BREAK)];
+    }
+    double total = accumulate(weights.begin(), weights.begin() + static_cast<ptrdiff_t>(len), 0.0);
+
+    double r = uniform_real_distribution<double>(0.0, total)(rng);
+    for (size_t i = 0; i < len; i++) {
+        r -= weights[i];
+        if (r <= 0.0) {
+            return abs(clause[i]);
+        }
+    }
+    return abs(clause[len - 1]);
+} /*}}}*/
+
+/*{{{ Flip a variable and incrementally update break/make counts and the unsat list */
+void LocalSearch::flip(int var) {
+    size_t v = static_cast<size_t>(var);
+    value[v] = -value[v];
+    int trueLit = value[v] > 0 ? var : -var;
+
+    // Clauses where var is now true
+    size_t t = litIndex(trueLit);
+    for (size_t i = occurStart[t]; i < occurStart[t + 1]; i++) {
+        uint32_t c = occurs[i];
+        trueVarXor[c] ^= var;
+        numTrue[c]++;
+        if (numTrue[c] == 1) {
+            removeUnsat(c);
+            breakCount[v]++;
+            for (size_t j = clauseStart[c]; j < clauseStart[c + 1]; j++) {
+                makeCount[static_cast<size_t>(abs(lits[j]))]--;
+            }
+        } else if (numTrue[c] == 2) {
+            // The previously critical variable is no longer the only true one
+            breakCount[static_cast<size_t>(trueVarXor[c] ^ var)]--;
+        }
+    }
+
+    // Clauses where var is now false
+    size_t f = litIndex(-trueLit);
+    for (size_t i = occurStart[f]; i < occurStart[f + 1]; i++) {
+        uint32_t c = occurs[i];
+        trueVarXor[c] ^= var;
+        numTrue[c]--;
+        if (numTrue[c] == 0) {
+            addUnsat(c);
+            breakCount[v]--;
+            for (size_t j = clauseStart[c]; j < clauseStart[c + 1]; j++) {
+                makeCount[static_cast<size_t>(abs(lits[j]))]++;
+            }
+        } else if (numTrue[c] == 1) {
+            breakCount[static_cast<size_t>(trueVarXor[c])]++;
+        }
+    }
+} /*}}}*/
+
+/*{{{ Best assignment: value with the trail since the best undone */
+void LocalSearch::saveBest() {
+    bestValue = value;
+    for (int var : sinceBest) {
+        size_t v = static_cast<size_t>(var);
+        bestValue[v] = -bestValue[v];
+    }
+    sinceBest.clear();
+    bestStale = false;
+} /*}}}*/
+
+/*{{{ Flip loop */
+bool LocalSearch::run(uint64_t maxFlips, Stats &stats) {
+    if (hasEmptyClause) {
+        return false;
+    }
+
+    Timer watch;
+    watch.start();
+    initAssignment();
+
+    const uint64_t CLOCK_INTERVAL = 4096; // Flips between cancellation checks
+    uint64_t flips = 0;
+    while (!unsat.empty() && flips < maxFlips) {
+        if (flips % CLOCK_INTERVAL == 0 && Cancel::expired()) {
+            break;
+        }
+        uint32_t c = unsat[rng() % unsat.size()];
+        int var = pickVar(c);
+        flip(var);
+        flips++;
+
+        if (unsat.size() < bestNumUnsat) {
+            // The current assignment is the new best; only the trail restarts
+            bestNumUnsat = unsat.size();
+            sinceBest.clear();
+            bestStale = true;
+        } else if (bestStale) {
+            sinceBest.push_back(var);
+            if (sinceBest.size() > static_cast<size_t>(numVars)) {
+                saveBest(); // Copying is now cheaper than keeping the trail
+            }
+        }
+    }
+    if (bestStale) {
+        saveBest();
+    }
+
+    watch.stop();
+    stats.flips += flips;
+    stats.slsTime += watch.getTime();
+    return unsat.empty();
+} /*}}}*/
+
+const vector<int> &LocalSearch::getPhases() const { return bestValue; }
+
+Assignment LocalSearch::getAssignment() const {
+    Assignment assignment;
+    for (int v = 1; v <= numVars; v++) {
+        assignment[v] = bestValue[static_cast<size_t>(v)];
+    }
+    return assignment;
+}
@@ -0,0 +1,154 @@
+#include "socket_io.h"
+#include "cancel.h"
+
+#include <cctype>
+#include <cstring>
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// How often a blocked read looks at the stop flag
+static const int POLL_MS = 200;
+
+/*{{{ Addresses */
+bool isUnixAddress(const string &address) {
+    return address.find('/') != string::npos || address.find(':') == string::npos;
+}
+
+// Calls connect or bind on a socket for each resolved address until one works
+template <typename Use> static int openSocket(const string &address, bool passive, Use use) {
+    if (isUnixAddress(address)) {
+        sockaddr_un unixAddress = {};
+        unixAddress.sun_family = AF_UNIX;
+        if (address.size() >= sizeof(unixAddress.sun_path)) {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        strcpy(unixAddress.sun_path, address.c_str());
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && !use(fd, reinterpret_cast<sockaddr *>(&unixAddress),
+                            static_cast<socklen_t>(sizeof(unixAddress)))) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            return -1;
+        }
+        return fd;
+    }
+
+    size_t colon = address.rfind(':');
+    string host = address.substr(0, colon), port = address.substr(colon + 1);
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    addrinfo *found = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &found) != 0) {
+        errno = EADDRNOTAVAIL;
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo *entry = found; entry != nullptr && fd < 0; entry = entry->ai_next) {
+        fd = socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol);
+        if (fd >= 0 && !use(fd, entry->ai_addr, entry->ai_addrlen)) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    return fd;
+}
+
+int listenOn(const string &address) {
+    if (isUnixAddress(address)) {
+        unlink(address.c_str()); // A stale socket from an earlier run
+    }
+    return openSocket(address, true, [](int fd, const sockaddr *where, socklen_t length) {
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        return bind(fd, where, length) == 0 && listen(fd, SOMAXCONN) == 0;
+    });
+}
+
+int connectTo(const string &address) {
+    return openSocket(address, false, [](int fd, const sockaddr *where, socklen_t length) {
+        return connect(fd, where, length) == 0;
+    });
+}
+
+void removeAddress(const string &address) {
+    if (isUnixAddress(address)) {
+        unlink(address.c_str());
+    }
+} /*}}}*/
+
+/*{{{ Reading and Writing */
+bool sendAll(int fd, const string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+LineReader::LineReader(int fd) : fd(fd), closed(false) {}
+
+bool LineReader::take(string &line) {
+    size_t end = buffer.find('\n');
+    if (end == string::npos) {
+        return false;
+    }
+    line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+    while (!line.empty() && isspace(static_cast<unsigned char>(line.back()))) {
+        line.pop_back();
+    }
+    return true;
+}
+
+bool LineReader::receive() {
+    char chunk[65536];
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) {
+        closed = true;
+        return false;
+    }
+    buffer.append(chunk, static_cast<size_t>(n));
+    return true;
+}
+
+bool LineReader::next(string &line) {
+    while (!take(line)) {
+        if (closed || Cancel::requested()) {
+            return false;
+        }
+        pollfd ready = {fd, POLLIN, 0};
+        if (::poll(&ready, 1, POLL_MS) > 0 && !receive()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LineReader::poll(string &line) {
+    while (!take(line)) {
+        pollfd ready = {fd, POLLIN, 0};
+        if (closed || ::poll(&ready, 1, 0) <= 0 || !receive()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LineReader::done() const { return closed && buffer.find('\n') == string::npos; } /*}}}*/
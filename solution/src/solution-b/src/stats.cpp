@@ -0,0 +1,48 @@
+#include "stats.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+// Per-second rate, or 0 when the phase did not run long enough to measure
+static double rate(uint64_t count, double seconds) {
+    return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+}
+
+string Stats::toJSON() const {
+    ostringstream buf;
+    buf << fixed << setprecision(0);
+    buf << "{\"Decisions\": " << decisions;
+    buf << ", \"PureLiterals\": " << pureLiterals;
+    buf << ", \"Propagations\": " << propagations;
+    buf << ", \"Conflicts\": " << conflicts;
+    buf << ", \"PropsPerSec\": " << rate(propagations, searchTime);
+    buf << ", \"Restarts\": " << restarts;
+    buf << ", \"LearnedClauses\": " << learnedClauses;
+    buf << ", \"AvgLearnedLength\": " << setprecision(2)
+        << (learnedClauses > 0 ? static_cast<double>(learnedLiterals) / static_cast<double>(learnedClauses) : 0.0)
+        << setprecision(0);
+    buf << ", \"DeletedClauses\": " << deletedClauses;
+    buf << ", \"ChronoBacktracks\": " << chronoBacktracks;
+    buf << ", \"TrailKept\": " << trailKept;
+    buf << ", \"PeakMemoryMB\": " << setprecision(2) << static_cast<double>(peakMemory) / (1024.0 * 1024.0)
+        << setprecision(0);
+    buf << ", \"MemoryReductions\": " << memoryReductions;
+    buf << ", \"AmoConstraints\": " << amoConstraints;
+    buf << ", \"AmoClausesRemoved\": " << amoClausesRemoved;
+    buf << ", \"SymmetryGenerators\": " << symmetryGenerators;
+    buf << ", \"SymmetryClauses\": " << symmetryClauses;
+    buf << ", \"CacheHits\": " << cacheHits;
+    buf << ", \"CubesSolved\": " << cubesSolved;
+    buf << ", \"CubeSplits\": " << cubeSplits;
+    buf << ", \"SharedClauses\": " << sharedClauses;
+    buf << ", \"VivifiedClauses\": " << vivifiedClauses;
+    buf << ", \"VivifiedLiterals\": " << vivifiedLiterals;
+    buf << ", \"VivifiedDeleted\": " << vivifiedDeleted;
+    buf << ", \"AvgClauseLength\": " << setprecision(2) << avgClauseLength << setprecision(0);
+    buf << ", \"Flips\": " << flips;
+    buf << ", \"FlipsPerSec\": " << rate(flips, slsTime);
+    buf << "}";
+    return buf.str();
+}
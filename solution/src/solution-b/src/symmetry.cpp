@@ -0,0 +1,299 @@
+#include "symmetry.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+using namespace std;
+
+// Partitions along the first path that are kept for generator search, to bound memory
+static const size_t MAX_LEVELS = 64;
+// Support variables of a generator covered by its lex-leader chain
+static const size_t MAX_CHAIN = 64;
+
+SymmetryBreaker::SymmetryBreaker() : firstAuxVar(0), timeBudget(0.0), numVars(0) {}
+
+/*{{{ Graph */
+uint32_t SymmetryBreaker::litVertex(int lit) const {
+    return 2 * static_cast<uint32_t>(abs(lit) - 1) + (lit < 0 ? 1u : 0u);
+}
+
+int SymmetryBreaker::vertexLit(uint32_t vertex) const {
+    int var = static_cast<int>(vertex / 2) + 1;
+    return vertex % 2 == 0 ? var : -var;
+}
+
+void SymmetryBreaker::buildGraph(const vector<Clause> &clauses) {
+    uint32_t numLits = 2 * static_cast<uint32_t>(numVars);
+    size_t numVertices = numLits + clauses.size();
+    vector<vector<uint32_t>> edges(numVertices);
+    for (uint32_t v = 0; v < numLits; v += 2) {
+        edges[v].push_back(v + 1); // A literal and its negation
+        edges[v + 1].push_back(v);
+    }
+    for (size_t ci = 0; ci < clauses.size(); ci++) {
+        uint32_t c = numLits + static_cast<uint32_t>(ci);
+        for (int lit : clauses[ci].literals) {
+            edges[litVertex(lit)].push_back(c);
+            edges[c].push_back(litVertex(lit));
+        }
+    }
+
+    adjStart.assign(1, 0);
+    adj.clear();
+    for (auto &neighbors : edges) {
+        sort(neighbors.begin(), neighbors.end());
+        adj.insert(adj.end(), neighbors.begin(), neighbors.end());
+        adjStart.push_back(adj.size());
+    }
+    initialColors.assign(numVertices, 1);
+    fill(initialColors.begin(), initialColors.begin() + numLits, 0);
+} /*}}}*/
+
+/*{{{ Partition Refinement */
+static uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Splits the cells of colors by the multiset of neighbor colors until that changes nothing.
+// New colors are the ranks of (color, neighbor hash), so they only depend on the partition and
+// not on vertex numbers. Returns the number of cells.
+size_t SymmetryBreaker::refine(vector<uint32_t> &colors) const {
+    size_t n = colors.size();
+    vector<uint64_t> hash(n);
+    vector<uint32_t> order(n), refined(n);
+    size_t cells = 0;
+    while (true) {
+        for (size_t v = 0; v < n; v++) {
+            uint64_t h = 0;
+            for (size_t k = adjStart[v]; k < adjStart[v + 1]; k++) {
+                h += mix(colors[adj[k]]);
+            }
+            hash[v] = h;
+        }
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return colors[a] != colors[b] ? colors[a] < colors[b] : hash[a] < hash[b];
+        });
+        uint32_t color = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (i > 0 && (colors[order[i]] != colors[order[i - 1]] ||
+                          hash[order[i]] != hash[order[i - 1]])) {
+                color++;
+            }
+            refined[order[i]] = color;
+        }
+        colors.swap(refined);
+        if (n == 0 || color + 1 == cells) {
+            return cells;
+        }
+        cells = color + 1;
+    }
+}
+
+// Gives vertex a cell of its own, ordered right after the rest of its old cell
+void SymmetryBreaker::individualize(vector<uint32_t> &colors, uint32_t vertex) const {
+    for (uint32_t &color : colors) {
+        color *= 2;
+    }
+    colors[vertex]++;
+}
+
+// Vertices of the lowest-colored cell with more than one vertex, empty if the partition is
+// discrete
+vector<uint32_t> SymmetryBreaker::targetCell(const vector<uint32_t> &colors) const {
+    vector<uint32_t> size(colors.size(), 0);
+    for (uint32_t color : colors) {
+        size[color]++;
+    }
+    uint32_t target = 0;
+    while (target < size.size() && size[target] < 2) {
+        target++;
+    }
+    vector<uint32_t> cell;
+    for (uint32_t v = 0; v < colors.size(); v++) {
+        if (colors[v] == target) {
+            cell.push_back(v);
+        }
+    }
+    return cell;
+}
+/*}}}*/
+
+/*{{{ Generator Search */
+// Refines and individualizes the first vertex of the target cell until the partition is
+// discrete. Returns false if the time budget ran out first.
+bool SymmetryBreaker::descend(vector<uint32_t> &colors) const {
+    while (true) {
+        refine(colors);
+        vector<uint32_t> cell = targetCell(colors);
+        if (cell.empty()) {
+            return true;
+        }
+        if (clock.getTime() > timeBudget) {
+            return false;
+        }
+        individualize(colors, cell[0]);
+    }
+}
+
+bool SymmetryBreaker::isAutomorphism(const vector<uint32_t> &perm) const {
+    vector<uint32_t> mapped;
+    for (uint32_t v = 0; v < perm.size(); v++) {
+        uint32_t image = perm[v];
+        if (initialColors[v] != initialColors[image] ||
+            adjStart[v + 1] - adjStart[v] != adjStart[image + 1] - adjStart[image]) {
+            return false;
+        }
+        mapped.clear();
+        for (size_t k = adjStart[v]; k < adjStart[v + 1]; k++) {
+            mapped.push_back(perm[adj[k]]);
+        }
+        sort(mapped.begin(), mapped.end());
+        auto imageAdj = adj.begin() + static_cast<ptrdiff_t>(adjStart[image]);
+        if (!equal(mapped.begin(), mapped.end(), imageAdj)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Follows the first path of the search tree to a discrete partition, then at each stored level
+// (deepest first) individualizes the other vertices of the target cell instead and descends to
+// another leaf. Matching the colors of two leaves gives a permutation, which is a generator if it
+// preserves the graph. Vertices already in the orbit of the first choice are skipped.
+vector<vector<uint32_t>> SymmetryBreaker::findGenerators() {
+    vector<vector<uint32_t>> generators;
+    vector<uint32_t> colors = initialColors;
+    vector<vector<uint32_t>> levels, cells;
+    while (true) {
+        refine(colors);
+        vector<uint32_t> cell = targetCell(colors);
+        if (cell.empty()) {
+            break;
+        }
+        if (clock.getTime() > timeBudget) {
+            return generators;
+        }
+        if (levels.size() < MAX_LEVELS) {
+            levels.push_back(colors);
+            cells.push_back(cell);
+        }
+        individualize(colors, cell[0]);
+    }
+    vector<uint32_t> firstLeaf(colors.size()); // Vertex of each color in the first leaf
+    for (uint32_t v = 0; v < colors.size(); v++) {
+        firstLeaf[colors[v]] = v;
+    }
+
+    vector<uint32_t> orbit(colors.size());
+    iota(orbit.begin(), orbit.end(), 0);
+    auto find = [&orbit](uint32_t v) {
+        while (orbit[v] != v) {
+            v = orbit[v] = orbit[orbit[v]];
+        }
+        return v;
+    };
+
+    for (size_t l = levels.size(); l-- > 0;) {
+        uint32_t first = cells[l][0];
+        for (size_t i = 1; i < cells[l].size(); i++) {
+            if (find(cells[l][i]) == find(first)) {
+                continue;
+            }
+            colors = levels[l];
+            individualize(colors, cells[l][i]);
+            if (!descend(colors)) {
+                return generators;
+            }
+            vector<uint32_t> perm(colors.size());
+            for (uint32_t v = 0; v < colors.size(); v++) {
+                perm[firstLeaf[colors[v]]] = v;
+            }
+            if (!isAutomorphism(perm)) {
+                continue;
+            }
+            for (uint32_t v = 0; v < perm.size(); v++) {
+                uint32_t a = find(v), b = find(perm[v]);
+                if (a != b) {
+                    orbit[a] = b;
+                }
+            }
+            generators.push_back(move(perm));
+        }
+    }
+    return generators;
+} /*}}}*/
+
+/*{{{ Lex-Leader Clauses */
+// Requires every model x to be lexicographically no larger than its image under the generator,
+// over the support variables in increasing order (false < true). Auxiliary variable p_i holds
+// when the first i positions are equal:
+//   p_{i-1} -> (x_i -> y_i),  p_{i-1} & x_i -> p_i,  p_{i-1} & -y_i -> p_i
+// where y_i is the image of x_i. A variable mapped to its own negation must be false and ends the
+// chain, since the positions cannot be equal past it.
+void SymmetryBreaker::addLexLeader(SATInstance &instance, const vector<uint32_t> &perm,
+                                   int &nextVar, Stats &stats) {
+    int prefix = 0; // p_{i-1}, 0 while it is trivially true
+    auto add = [&](vector<int> literals) {
+        if (prefix != 0) {
+            literals.push_back(-prefix);
+        }
+        instance.addClause(literals);
+        stats.symmetryClauses++;
+    };
+
+    size_t length = 0;
+    for (int x = 1; x <= numVars && length < MAX_CHAIN; x++) {
+        int y = vertexLit(perm[litVertex(x)]);
+        if (y == x) {
+            continue;
+        }
+        length++;
+        if (y == -x) {
+            add({-x});
+            break;
+        }
+        add({-x, y});
+        int p = nextVar++;
+        add({-x, p});
+        add({y, p});
+        prefix = p;
+    }
+} /*}}}*/
+
+void SymmetryBreaker::apply(SATInstance &instance, double budget, Stats &stats) {
+    clock.start();
+    timeBudget = budget;
+
+    // Trust the literals over the problem line in case it undercounts
+    numVars = instance.getNumVars();
+    for (const Clause &clause : instance.clauses) {
+        for (int lit : clause.literals) {
+            numVars = max(numVars, abs(lit));
+        }
+    }
+    buildGraph(instance.clauses);
+    vector<vector<uint32_t>> generators = findGenerators();
+
+    int nextVar = numVars + 1;
+    for (const auto &perm : generators) {
+        addLexLeader(instance, perm, nextVar, stats);
+    }
+    firstAuxVar = nextVar > numVars + 1 ? numVars + 1 : 0;
+    stats.symmetryGenerators += generators.size();
+
+    adjStart.clear();
+    adj.clear();
+    initialColors.clear();
+}
+
+void SymmetryBreaker::strip(Assignment &assignment) const {
+    if (firstAuxVar == 0) {
+        return;
+    }
+    erase_if(assignment, [this](const auto &entry) { return entry.first >= firstAuxVar; });
+}
@@ -0,0 +1,158 @@
+#include "trace.h"
+
+#ifdef SAT_TRACE
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+using namespace std;
+
+#ifdef SAT_TRACE
+// Records per thread between two drains; 384 KiB per buffer
+static const size_t RING_SIZE = size_t(1) << 14;
+static const auto FLUSH_INTERVAL = chrono::milliseconds(20);
+
+/*{{{ Ring Buffers */
+// Single producer (the owning thread), single consumer (the flusher)
+struct Ring {
+    array<TraceRecord, RING_SIZE> records;
+    atomic<uint64_t> head{0}; // Next record to write, advanced by the owner
+    atomic<uint64_t> tail{0}; // Next record to flush, advanced by the flusher
+    atomic<uint64_t> dropped{0};
+    uint16_t thread = 0;
+};
+
+static mutex traceLock; // Guards rings, file and the flusher state below
+static vector<unique_ptr<Ring>> rings;
+static FILE *file = nullptr;
+static thread flusher;
+static condition_variable wake;
+static bool stopping = false;
+static atomic<bool> active{false};
+static chrono::steady_clock::time_point origin;
+
+// Rings outlive their threads, so the flusher never sees one disappear
+static Ring *localRing() {
+    thread_local Ring *ring = nullptr;
+    if (ring == nullptr) {
+        lock_guard<mutex> guard(traceLock);
+        rings.push_back(make_unique<Ring>());
+        ring = rings.back().get();
+        ring->thread = static_cast<uint16_t>(rings.size() - 1);
+    }
+    return ring;
+}
+
+// Writes what each ring holds; the caller has the lock
+static void drain() {
+    for (auto &ring : rings) {
+        uint64_t head = ring->head.load(memory_order_acquire);
+        uint64_t tail = ring->tail.load(memory_order_relaxed);
+        while (tail < head) {
+            size_t start = static_cast<size_t>(tail % RING_SIZE);
+            size_t count = min(static_cast<size_t>(head - tail), RING_SIZE - start);
+            fwrite(&ring->records[start], sizeof(TraceRecord), count, file);
+            tail += count;
+        }
+        ring->tail.store(tail, memory_order_release);
+    }
+}
+
+static void flushLoop() {
+    unique_lock<mutex> guard(traceLock);
+    while (!stopping) {
+        wake.wait_for(guard, FLUSH_INTERVAL);
+        drain();
+    }
+} /*}}}*/
+
+bool Trace::open(const string &path) {
+    close();
+    lock_guard<mutex> guard(traceLock);
+    file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    TraceHeader header = {};
+    copy(begin(TRACE_MAGIC), end(TRACE_MAGIC), header.magic);
+    header.version = TRACE_VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    fwrite(&header, sizeof(header), 1, file);
+
+    for (auto &ring : rings) { // Left over from an earlier trace
+        ring->tail.store(ring->head.load());
+        ring->dropped.store(0);
+    }
+    origin = chrono::steady_clock::now();
+    stopping = false;
+    flusher = thread(flushLoop);
+    active.store(true, memory_order_release);
+    return true;
+}
+
+void Trace::close() {
+    if (!active.exchange(false)) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(traceLock);
+        stopping = true;
+        wake.notify_all();
+    }
+    flusher.join();
+
+    lock_guard<mutex> guard(traceLock);
+    drain();
+    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin);
+    for (auto &ring : rings) {
+        uint64_t dropped = ring->dropped.load();
+        if (dropped > 0) {
+            int32_t count = static_cast<int32_t>(min<uint64_t>(dropped, INT32_MAX));
+            TraceRecord record = {static_cast<uint64_t>(elapsed.count()), TraceEvent::Dropped,
+                                  ring->thread, 0, count, 0};
+            fwrite(&record, sizeof(record), 1, file);
+        }
+    }
+    fclose(file);
+    file = nullptr;
+}
+
+void Trace::record(TraceEvent event, int level, int64_t a, int64_t b) {
+    if (!active.load(memory_order_relaxed)) {
+        return;
+    }
+    Ring *ring = localRing();
+    uint64_t head = ring->head.load(memory_order_relaxed);
+    if (head - ring->tail.load(memory_order_acquire) == RING_SIZE) {
+        ring->dropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    auto elapsed = chrono::steady_clock::now() - origin;
+    ring->records[static_cast<size_t>(head % RING_SIZE)] = {
+        static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(elapsed).count()),
+        event,
+        ring->thread,
+        level,
+        static_cast<int32_t>(a),
+        static_cast<int32_t>(b),
+    };
+    ring->head.store(head + 1, memory_order_release);
+}
+
+// Drains the buffers when main returns or exit() is called
+static struct CloseAtExit {
+    ~CloseAtExit() { Trace::close(); }
+} closeAtExit;
+#else
+bool Trace::open(const string &) { return false; }
+void Trace::close() {}
+void Trace::record(TraceEvent, int, int64_t, int64_t) {}
+#endif
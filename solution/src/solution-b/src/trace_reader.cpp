@@ -0,0 +1,221 @@
+// Reads a trace written by main --trace (see trace.h). Prints a JSON summary with the event
+// counts and a timeline of the search in equal windows, or exports the trace as Chrome trace
+// JSON for chrome://tracing or Perfetto:
+//   trace_reader <trace> [--windows <n>] [--chrome <out.json>]
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const char *const EVENT_NAMES[] = {"SolveBegin", "SolveEnd", "Decide",  "Propagate",
+                                          "Conflict",   "Learn",    "Restart", "Dropped"};
+static const size_t NUM_EVENTS = sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]);
+
+static size_t eventIndex(TraceEvent event) { return static_cast<size_t>(event); }
+
+static vector<TraceRecord> readTrace(const string &fileName) {
+    ifstream file(fileName, ios::binary);
+    TraceHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        throw runtime_error("Error: not a trace file: " + fileName);
+    }
+    if (header.version != TRACE_VERSION || header.recordSize != sizeof(TraceRecord)) {
+        throw runtime_error("Error: unsupported trace version: " + fileName);
+    }
+    vector<TraceRecord> records;
+    TraceRecord record;
+    while (file.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        if (eventIndex(record.event) >= NUM_EVENTS) {
+            throw runtime_error("Error: corrupt trace record in " + fileName);
+        }
+        records.push_back(record);
+    }
+    // Each thread's records are in order, but the flusher interleaves the threads in batches
+    stable_sort(records.begin(), records.end(),
+                [](const TraceRecord &x, const TraceRecord &y) { return x.nanos < y.nanos; });
+    return records;
+}
+
+/*{{{ Summary */
+struct Window {
+    uint64_t counts[NUM_EVENTS] = {};
+    uint64_t propagated = 0;
+    uint64_t learnedLiterals = 0;
+    uint64_t backjumps = 0;
+    uint64_t conflictLevels = 0;
+
+    void add(const TraceRecord &record) {
+        counts[eventIndex(record.event)]++;
+        switch (record.event) {
+        case TraceEvent::Propagate:
+            propagated += static_cast<uint64_t>(record.a);
+            break;
+        case TraceEvent::Learn:
+            learnedLiterals += static_cast<uint64_t>(record.a);
+            backjumps += static_cast<uint64_t>(record.b);
+            conflictLevels += static_cast<uint64_t>(record.level);
+            break;
+        default:
+            break;
+        }
+    }
+
+    string toJSON(double seconds) const {
+        uint64_t learned = counts[eventIndex(TraceEvent::Learn)];
+        auto average = [learned](uint64_t total) {
+            return learned == 0 ? 0.0 : static_cast<double>(total) / static_cast<double>(learned);
+        };
+        auto rate = [seconds](uint64_t count) {
+            return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+        };
+        ostringstream buf;
+        buf << fixed << setprecision(2) << "{\"Decisions\": "
+            << counts[eventIndex(TraceEvent::Decide)] << ", \"Conflicts\": "
+            << counts[eventIndex(TraceEvent::Conflict)] << ", \"Propagations\": " << propagated
+            << ", \"Restarts\": " << counts[eventIndex(TraceEvent::Restart)]
+            << ", \"ConflictsPerSec\": " << rate(counts[eventIndex(TraceEvent::Conflict)])
+            << ", \"AvgLearnedSize\": " << average(learnedLiterals)
+            << ", \"AvgBackjump\": " << average(backjumps)
+            << ", \"AvgConflictLevel\": " << average(conflictLevels) << "}";
+        return buf.str();
+    }
+};
+
+static void printSummary(const vector<TraceRecord> &records, size_t numWindows) {
+    // From the first to the last record, leaving out the parsing before the search
+    uint64_t first = records.empty() ? 0 : records.front().nanos;
+    uint64_t last = records.empty() ? 0 : records.back().nanos;
+    double seconds = static_cast<double>(last - first) * 1e-9;
+    Window total;
+    vector<Window> windows(numWindows);
+    uint64_t dropped = 0;
+    uint16_t threads = 0;
+    for (const TraceRecord &record : records) {
+        if (record.event == TraceEvent::Dropped) {
+            dropped += static_cast<uint64_t>(record.a);
+            continue;
+        }
+        total.add(record);
+        double offset = static_cast<double>(record.nanos - first) * 1e-9;
+        size_t w = seconds > 0.0
+                       ? static_cast<size_t>(offset / seconds * static_cast<double>(numWindows))
+                       : 0;
+        windows[min(w, numWindows - 1)].add(record);
+        threads = max(threads, static_cast<uint16_t>(record.thread + 1));
+    }
+
+    cout << fixed << setprecision(3) << "{\"Records\": " << records.size()
+         << ", \"Threads\": " << threads << ", \"Seconds\": " << seconds
+         << ", \"Dropped\": " << dropped << ", \"Events\": {";
+    for (size_t e = 0; e < NUM_EVENTS; e++) {
+        cout << (e > 0 ? ", " : "") << "\"" << EVENT_NAMES[e] << "\": " << total.counts[e];
+    }
+    cout << "},\n \"Total\": " << total.toJSON(seconds) << ",\n \"Windows\": [";
+    for (size_t w = 0; w < numWindows; w++) {
+        cout << (w > 0 ? ",\n  " : "\n  ") << "{\"Start\": " << fixed << setprecision(3)
+             << seconds * static_cast<double>(w) / static_cast<double>(numWindows)
+             << ", \"Stats\": " << windows[w].toJSON(seconds / static_cast<double>(numWindows))
+             << "}";
+    }
+    cout << "]}" << endl;
+} /*}}}*/
+
+/*{{{ Chrome Trace */
+// Solves are duration events, restarts and learned clauses instant events, and the decision
+// level and trail size counters. Decisions and propagations are only counted in the summary,
+// since there are too many for the viewer.
+static void writeChrome(const vector<TraceRecord> &records, const string &fileName) {
+    ofstream out(fileName);
+    if (!out) {
+        throw runtime_error("Error: cannot write " + fileName);
+    }
+    out << "{\"traceEvents\": [\n";
+    bool first = true;
+    auto event = [&](const TraceRecord &record, const string &name, const string &phase,
+                     const string &args) {
+        out << (first ? "" : ",\n") << "{\"name\": \"" << name << "\", \"ph\": \"" << phase
+            << "\", \"ts\": " << fixed << setprecision(3)
+            << static_cast<double>(record.nanos) / 1000.0 << ", \"pid\": 1, \"tid\": "
+            << record.thread;
+        if (phase == "i") {
+            out << ", \"s\": \"t\"";
+        }
+        if (!args.empty()) {
+            out << ", \"args\": {" << args << "}";
+        }
+        out << "}";
+        first = false;
+    };
+
+    for (const TraceRecord &record : records) {
+        string level = "\"Level\": " + to_string(record.level);
+        switch (record.event) {
+        case TraceEvent::SolveBegin:
+            event(record, "Solve", "B", "\"Assumptions\": " + to_string(record.a));
+            break;
+        case TraceEvent::SolveEnd:
+            event(record, "Solve", "E", "\"Result\": " + to_string(record.a));
+            break;
+        case TraceEvent::Conflict:
+            event(record, "Search", "C", level + ", \"Trail\": " + to_string(record.b));
+            break;
+        case TraceEvent::Learn:
+            event(record, "Learn", "i",
+                  "\"Size\": " + to_string(record.a) + ", \"Backjump\": " + to_string(record.b));
+            break;
+        case TraceEvent::Restart:
+            event(record, "Restart", "i",
+                  "\"Restarts\": " + to_string(record.a) + ", \"Learned\": " + to_string(record.b));
+            break;
+        default:
+            break;
+        }
+    }
+    out << "\n]}\n";
+} /*}}}*/
+
+int main(int argc, char *argv[]) {
+    string input, chrome;
+    size_t numWindows = 10;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--chrome" && i + 1 < argc) {
+            chrome = argv[++i];
+        } else if (arg == "--windows" && i + 1 < argc) {
+            numWindows = max<size_t>(stoull(argv[++i]), 1);
+        } else if (arg.rfind("--", 0) == 0 || !input.empty()) {
+            input.clear();
+            break;
+        } else {
+            input = arg;
+        }
+    }
+    if (input.empty()) {
+        cout << "Usage: " << argv[0] << " <trace> [--windows <n>] [--chrome <out.json>]" << endl;
+        return 1;
+    }
+
+    try {
+        vector<TraceRecord> records = readTrace(input);
+        if (chrome.empty()) {
+            printSummary(records, numWindows);
+        } else {
+            writeChrome(records, chrome);
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
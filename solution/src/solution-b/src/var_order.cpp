@@ -0,0 +1,111 @@
+#include "var_order.h"
+
+using namespace std;
+
+static const double DECAY = 0.95;
+static const double RESCALE_LIMIT = 1e100;
+
+VarOrder::VarOrder() : increment(1.0) {}
+
+void VarOrder::init(int numVars) {
+    size_t n = static_cast<size_t>(numVars) + 1;
+    activity.assign(n, 0.0);
+    position.assign(n, -1);
+    heap.clear();
+    increment = 1.0;
+}
+
+void VarOrder::grow(int numVars) {
+    size_t n = static_cast<size_t>(numVars) + 1;
+    if (n > activity.size()) {
+        activity.resize(n, 0.0);
+        position.resize(n, -1);
+    }
+}
+
+void VarOrder::setActivity(int var, double value) {
+    activity[static_cast<size_t>(var)] = value;
+    if (contains(var)) {
+        up(static_cast<size_t>(position[static_cast<size_t>(var)]));
+        down(static_cast<size_t>(position[static_cast<size_t>(var)]));
+    }
+}
+
+void VarOrder::bump(int var) {
+    size_t v = static_cast<size_t>(var);
+    activity[v] += increment;
+    if (activity[v] > RESCALE_LIMIT) {
+        for (double &a : activity) {
+            a /= RESCALE_LIMIT;
+        }
+        increment /= RESCALE_LIMIT;
+    }
+    if (contains(var)) {
+        up(static_cast<size_t>(position[v]));
+    }
+}
+
+void VarOrder::decay() { increment /= DECAY; }
+
+void VarOrder::insert(int var) {
+    if (contains(var)) {
+        return;
+    }
+    position[static_cast<size_t>(var)] = static_cast<int>(heap.size());
+    heap.push_back(var);
+    up(heap.size() - 1);
+}
+
+bool VarOrder::contains(int var) const { return position[static_cast<size_t>(var)] >= 0; }
+
+bool VarOrder::empty() const { return heap.empty(); }
+
+int VarOrder::removeMax() {
+    int top = heap[0];
+    heap[0] = heap.back();
+    position[static_cast<size_t>(heap[0])] = 0;
+    heap.pop_back();
+    position[static_cast<size_t>(top)] = -1;
+    if (!heap.empty()) {
+        down(0);
+    }
+    return top;
+}
+
+/*{{{ Heap maintenance */
+bool VarOrder::before(int a, int b) const {
+    return activity[static_cast<size_t>(a)] > activity[static_cast<size_t>(b)];
+}
+
+void VarOrder::up(size_t i) {
+    int var = heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!before(var, heap[parent])) {
+            break;
+        }
+        heap[i] = heap[parent];
+        position[static_cast<size_t>(heap[i])] = static_cast<int>(i);
+        i = parent;
+    }
+    heap[i] = var;
+    position[static_cast<size_t>(var)] = static_cast<int>(i);
+}
+
+void VarOrder::down(size_t i) {
+    int var = heap[i];
+    while (2 * i + 1 < heap.size()) {
+        size_t child = 2 * i + 1;
+        if (child + 1 < heap.size() && before(heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!before(heap[child], var)) {
+            break;
+        }
+        heap[i] = heap[child];
+        position[static_cast<size_t>(heap[i])] = static_cast<int>(i);
+        i = child;
+    }
+    heap[i] = var;
+    position[static_cast<size_t>(var)] = static_cast<int>(i);
+} /*}}}*/